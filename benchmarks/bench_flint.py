@@ -0,0 +1,297 @@
+# Copyright (c) 2023, Jef Wagner <jefwagner@gmail.com>
+# This file is part of numpy-flint.
+#
+# Numpy-flint is free software: you can redistribute it and/or modify it under
+# the terms of the GNU General Public License as published by the Free Software
+# Foundation, either version 3 of the License, or (at your option) any later
+# version.
+#
+# Numpy-flint is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+# details.
+#
+# You should have received a copy of the GNU General Public License along with
+# numpy-flint. If not, see <https://www.gnu.org/licenses/>.
+"""
+Benchmarks for the flint scalars, ufuncs, casts, and array functions
+
+The benchmarks use the conventions of `airspeed velocity <https://asv.readthedocs.io>`_,
+so ``asv run`` from the root of the repo tracks them between versions. Every array
+benchmark is also run on float64 arrays, which is the baseline that makes the numbers
+comparable between cpus. Without asv, ``python benchmarks/bench_flint.py [pattern]``
+times each benchmark that matches the pattern and prints its time relative to the
+float64 baseline.
+"""
+import itertools
+import pickle
+import re
+import sys
+import timeit
+
+import numpy as np
+import flint as flint_module
+from flint import flint, flint32
+
+DTYPES = ['float64', 'flint', 'flint32']
+SIZES = [100, 10000, 1000000]
+STRIDES = [1, 3]
+
+UNARY = ['negative', 'positive', 'absolute', 'square', 'sqrt', 'cbrt', 'exp', 'exp2',
+         'expm1', 'log', 'log10', 'log2', 'log1p', 'sin', 'cos', 'tan', 'arcsin',
+         'arccos', 'arctan', 'sinh', 'cosh', 'tanh', 'arcsinh', 'arccosh', 'arctanh',
+         'isnan', 'isinf', 'isfinite', 'floor', 'ceil', 'trunc', 'rint']
+BINARY = ['add', 'subtract', 'multiply', 'true_divide', 'power', 'minimum', 'maximum',
+          'fmin', 'fmax', 'hypot', 'arctan2', 'equal', 'not_equal', 'less', 'less_equal',
+          'greater', 'greater_equal', 'fmod', 'remainder', 'floor_divide']
+MIXED = ['add', 'subtract', 'multiply', 'true_divide', 'equal', 'less']
+
+# The inputs of the functions that are not defined on (0.1, 2)
+DOMAIN = {'arcsin': (-0.9, 0.9), 'arccos': (-0.9, 0.9), 'arctanh': (-0.9, 0.9),
+          'arccosh': (1.1, 10.0)}
+
+def _dtype(name):
+    return {'float64': np.float64, 'float32': np.float32, 'int64': np.int64,
+            'flint': flint, 'flint32': flint32}[name]
+
+def _array(dtype, size, stride=1, lo=0.1, hi=2.0, seed=0):
+    """Return a strided array of uniform random numbers"""
+    x = np.random.RandomState(seed).uniform(lo, hi, size*stride)
+    return x.astype(_dtype(dtype))[::stride]
+
+def _supported(func, *args):
+    """Skip the benchmark if the function does not work for the arguments"""
+    try:
+        func(*args)
+    except TypeError:
+        raise NotImplementedError
+
+
+class Scalar:
+    """Arithmetic on single python floats and flints"""
+    params = [['float', 'flint', 'flint32']]
+    param_names = ['type']
+
+    def setup(self, t):
+        cls = {'float': float, 'flint': flint, 'flint32': flint32}[t]
+        self.x = cls(1.5)
+        self.y = cls(0.7)
+
+    def time_new(self, t):
+        type(self.x)(0.1)
+
+    def time_add(self, t):
+        self.x + self.y
+
+    def time_multiply(self, t):
+        self.x * self.y
+
+    def time_divide(self, t):
+        self.x / self.y
+
+    def time_power(self, t):
+        self.x ** self.y
+
+    def time_less(self, t):
+        self.x < self.y
+
+
+class UnaryUfunc:
+    """Every unary ufunc with a flint loop"""
+    params = [UNARY, DTYPES, SIZES, STRIDES]
+    param_names = ['ufunc', 'dtype', 'size', 'stride']
+
+    def setup(self, name, dtype, size, stride):
+        self.f = getattr(np, name)
+        self.x = _array(dtype, size, stride, *DOMAIN.get(name, (0.1, 2.0)))
+        self.out = np.empty(size, dtype=self.f(self.x[:1]).dtype)
+
+    def time_ufunc(self, name, dtype, size, stride):
+        self.f(self.x, out=self.out)
+
+
+class BinaryUfunc:
+    """Every binary ufunc with a flint loop"""
+    params = [BINARY, DTYPES, SIZES, STRIDES]
+    param_names = ['ufunc', 'dtype', 'size', 'stride']
+
+    def setup(self, name, dtype, size, stride):
+        self.f = getattr(np, name)
+        self.x = _array(dtype, size, stride, seed=0)
+        self.y = _array(dtype, size, stride, seed=1)
+        self.out = np.empty(size, dtype=self.f(self.x[:1], self.y[:1]).dtype)
+
+    def time_ufunc(self, name, dtype, size, stride):
+        self.f(self.x, self.y, out=self.out)
+
+
+class MixedUfunc:
+    """The loops that take a flint and a float64 array"""
+    params = [MIXED, DTYPES, SIZES]
+    param_names = ['ufunc', 'dtype', 'size']
+
+    def setup(self, name, dtype, size):
+        self.f = getattr(np, name)
+        self.x = _array(dtype, size, seed=0)
+        self.y = _array('float64', size, seed=1)
+
+    def time_ufunc(self, name, dtype, size):
+        self.f(self.x, self.y)
+
+
+class PowerInt:
+    """Powers with an integer exponent"""
+    params = [DTYPES, SIZES]
+    param_names = ['dtype', 'size']
+
+    def setup(self, dtype, size):
+        self.x = _array(dtype, size)
+        self.n = np.full(size, 3, dtype=np.int64)
+
+    def time_power(self, dtype, size):
+        np.power(self.x, self.n)
+
+
+class Cast:
+    """Conversions between float64, integers, flints, and flint32s"""
+    params = [[('float64', 'float32'), ('float64', 'flint'), ('int64', 'flint'),
+               ('flint', 'float64'), ('flint', 'flint32'), ('flint32', 'flint'),
+               ('float64', 'flint32')], SIZES]
+    param_names = ['types', 'size']
+
+    def setup(self, types, size):
+        self.x = _array(types[0], size, lo=-100, hi=100)
+        self.to = _dtype(types[1])
+
+    def time_astype(self, types, size):
+        self.x.astype(self.to)
+
+
+class Reduce:
+    """Reductions along a whole array"""
+    params = [['add', 'multiply', 'minimum', 'maximum'], DTYPES, SIZES]
+    param_names = ['ufunc', 'dtype', 'size']
+
+    def setup(self, name, dtype, size):
+        self.f = getattr(np, name)
+        self.x = _array(dtype, size, lo=0.999, hi=1.001)
+
+    def time_reduce(self, name, dtype, size):
+        self.f.reduce(self.x)
+
+
+class Dot:
+    """Matrix products and dot products"""
+    params = [DTYPES, [10, 100, 300]]
+    param_names = ['dtype', 'size']
+
+    def setup(self, dtype, size):
+        self.a = _array(dtype, size*size, seed=0).reshape(size, size)
+        self.b = _array(dtype, size*size, seed=1).reshape(size, size)
+        self.x = _array(dtype, size*size, seed=2)
+        _supported(np.matmul, self.a[:1, :1], self.b[:1, :1])
+        _supported(np.dot, self.x[:1], self.x[:1])
+
+    def time_matmul(self, dtype, size):
+        self.a @ self.b
+
+    def time_dot(self, dtype, size):
+        np.dot(self.x, self.x)
+
+
+class Sort:
+    """Sorting and arg-sorting random arrays"""
+    params = [DTYPES, [1000, 100000]]
+    param_names = ['dtype', 'size']
+
+    def setup(self, dtype, size):
+        self.x = _array(dtype, size)
+
+    def time_sort(self, dtype, size):
+        np.sort(self.x)
+
+    def time_argsort(self, dtype, size):
+        np.argsort(self.x)
+
+
+class Serialize:
+    """Pickling and the compact byte format"""
+    params = [DTYPES, [1000, 1000000]]
+    param_names = ['dtype', 'size']
+
+    def setup(self, dtype, size):
+        self.x = _array(dtype, size)
+        self.data = pickle.dumps(self.x, protocol=5)
+
+    def time_dumps(self, dtype, size):
+        pickle.dumps(self.x, protocol=5)
+
+    def time_loads(self, dtype, size):
+        pickle.loads(self.data)
+
+    def time_to_bytes(self, dtype, size):
+        if dtype == 'float64':
+            self.x.tobytes()
+        else:
+            flint_module.to_bytes(self.x)
+
+
+class Evaluate:
+    """A chain of ufuncs and the same expression fused by flint.evaluate
+
+    The float64 version of time_evaluate runs the chain of float64 ufuncs, so it is the
+    baseline for both.
+    """
+    params = [DTYPES, SIZES]
+    param_names = ['dtype', 'size']
+
+    def setup(self, dtype, size):
+        self.x = _array(dtype, size, seed=0)
+        self.y = _array(dtype, size, seed=1)
+        self.k = _dtype(dtype)(0.1)
+        self.names = {'x': self.x, 'y': self.y, 'k': self.k}
+
+    def time_chain(self, dtype, size):
+        np.sqrt(self.x*self.x + self.y*self.y)*self.k
+
+    def time_evaluate(self, dtype, size):
+        if dtype == 'float64':
+            np.sqrt(self.x*self.x + self.y*self.y)*self.k
+        else:
+            flint_module.evaluate('sqrt(x*x + y*y)*k', self.names)
+
+
+BENCHMARKS = [Scalar, UnaryUfunc, BinaryUfunc, MixedUfunc, PowerInt, Cast, Reduce, Dot,
+              Sort, Serialize, Evaluate]
+
+def _baseline(cls, params):
+    """Return the float64 version of the parameters, or None"""
+    for i, name in enumerate(cls.param_names):
+        if name in ('dtype', 'type') and params[i] not in ('float64', 'float'):
+            return params[:i] + ('float' if name == 'type' else 'float64',) + params[i+1:]
+    return None
+
+def main(pattern=''):
+    """Time each benchmark once and print the time relative to the float64 baseline"""
+    times = {}
+    print(f"{'benchmark':<56} {'time':>12} {'vs float64':>10}")
+    for cls in BENCHMARKS:
+        for params in itertools.product(*cls.params):
+            bench = cls()
+            try:
+                bench.setup(*params)
+            except NotImplementedError:
+                continue
+            for method in sorted(m for m in dir(cls) if m.startswith('time_')):
+                label = f"{cls.__name__}.{method}{params}"
+                if not re.search(pattern, label):
+                    continue
+                func = getattr(bench, method)
+                n, t = timeit.Timer(lambda: func(*params)).autorange()
+                times[(cls, method, params)] = t/n
+                base = times.get((cls, method, _baseline(cls, params)))
+                ratio = f"{t/n/base:10.2f}" if base else ''
+                print(f"{label:<56} {t/n*1e6:10.2f}us {ratio}")
+
+if __name__ == '__main__':
+    main(*sys.argv[1:2])
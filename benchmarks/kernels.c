@@ -0,0 +1,150 @@
+/**
+ * Microbenchmarks for the flint.h kernels against the same double operations
+ */
+// Copyright (c) 2023, Jef Wagner <jefwagner@gmail.com>
+//
+// This file is part of numpy-flint.
+//
+// Numpy-flint is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// Numpy-flint is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// numpy-flint. If not, see <https://www.gnu.org/licenses/>.
+//
+// Build and run from the root of the repo with the same flags as the extension, for
+// example
+//
+//     cc -O2 -fno-math-errno -Isrc/flint benchmarks/kernels.c -o kernels -lm
+//     ./kernels [size] [stride]
+//
+// Adding -DFLINT_DIRECTED_ROUNDING benchmarks the directed rounding kernels. Each line
+// gives the time per element of the double loop, the flint loop, and their ratio.
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <flint.h>
+
+/// @brief Stop the compiler from removing or merging the repeated loops
+#if defined(__GNUC__) || defined(__clang__)
+#define BENCH_CLOBBER(p) __asm__ volatile("" : : "g"(p) : "memory")
+#else
+#define BENCH_CLOBBER(p) ((void) (p))
+#endif
+
+/// @brief The number of elements run through each kernel in total
+#define BENCH_TOTAL 20000000
+
+/// @brief The time in seconds from a monotonic clock
+static double bench_now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + 1e-9*t.tv_nsec;
+}
+
+/// @brief Time a loop over the double arrays and the same loop over the flint arrays
+/// @param name The name of the kernel
+/// @param dstmt The statement for element i of the double arrays xd, yd, zd, and od
+/// @param fstmt The statement for element i of the flint arrays xf, yf, zf, and of
+#define BENCH(name, dstmt, fstmt) do { \
+    double t0, td, tf; \
+    t0 = bench_now(); \
+    for (r=0; r<reps; r++) { \
+        for (i=0; i<n*s; i+=s) { \
+            dstmt; \
+        } \
+        BENCH_CLOBBER(od); \
+    } \
+    td = bench_now() - t0; \
+    t0 = bench_now(); \
+    for (r=0; r<reps; r++) { \
+        for (i=0; i<n*s; i+=s) { \
+            fstmt; \
+        } \
+        BENCH_CLOBBER(of); \
+    } \
+    tf = bench_now() - t0; \
+    sink += od[0] + of[0].v; \
+    printf("%-12s %10.2f %10.2f %8.2f\n", name, 1e9*td/(reps*n), 1e9*tf/(reps*n), tf/td); \
+} while (0)
+
+int main(int argc, char** argv) {
+    long n = (argc > 1) ? atol(argv[1]) : 1000;
+    long s = (argc > 2) ? atol(argv[2]) : 1;
+    long reps, r, i;
+    double *xd, *yd, *zd, *od;
+    flint *xf, *yf, *zf, *of;
+    int* ob;
+    volatile double sink = 0.0;
+    if (n < 1 || s < 1) {
+        fprintf(stderr, "usage: %s [size] [stride]\n", argv[0]);
+        return 1;
+    }
+    reps = (BENCH_TOTAL/n > 0) ? BENCH_TOTAL/n : 1;
+    xd = malloc(n*s*sizeof(double)); yd = malloc(n*s*sizeof(double));
+    zd = malloc(n*s*sizeof(double)); od = malloc(n*s*sizeof(double));
+    xf = malloc(n*s*sizeof(flint)); yf = malloc(n*s*sizeof(flint));
+    zf = malloc(n*s*sizeof(flint)); of = malloc(n*s*sizeof(flint));
+    ob = malloc(n*s*sizeof(int));
+    if (!xd || !yd || !zd || !od || !xf || !yf || !zf || !of || !ob) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    srand(0);
+    for (i=0; i<n*s; i++) {
+        xd[i] = 0.1 + 1.8*rand()/RAND_MAX;
+        yd[i] = 0.1 + 1.8*rand()/RAND_MAX;
+        zd[i] = -0.9 + 1.8*rand()/RAND_MAX;
+        xf[i] = double_to_flint(xd[i]);
+        yf[i] = double_to_flint(yd[i]);
+        zf[i] = double_to_flint(zd[i]);
+    }
+    printf("size %ld, stride %ld, %s rounding\n", n, s,
+#ifdef FLINT_DIRECTED_ROUNDING
+           "directed"
+#else
+           "nextafter"
+#endif
+    );
+    printf("%-12s %10s %10s %8s\n", "kernel", "double ns", "flint ns", "ratio");
+    BENCH("cast", od[i] = (double) (float) zd[i], of[i] = double_to_flint(zd[i]));
+    BENCH("negative", od[i] = -xd[i], of[i] = flint_negative(xf[i]));
+    BENCH("absolute", od[i] = fabs(zd[i]), of[i] = flint_absolute(zf[i]));
+    BENCH("add", od[i] = xd[i] + yd[i], of[i] = flint_add(xf[i], yf[i]));
+    BENCH("subtract", od[i] = xd[i] - yd[i], of[i] = flint_subtract(xf[i], yf[i]));
+    BENCH("multiply", od[i] = xd[i]*yd[i], of[i] = flint_multiply(xf[i], yf[i]));
+    BENCH("divide", od[i] = xd[i]/yd[i], of[i] = flint_divide(xf[i], yf[i]));
+    BENCH("fma", od[i] = fma(xd[i], yd[i], zd[i]), of[i] = flint_fma(xf[i], yf[i], zf[i]));
+    BENCH("less", ob[i] = xd[i] < yd[i], ob[i] = flint_lt(xf[i], yf[i]));
+    BENCH("square", od[i] = xd[i]*xd[i], of[i] = flint_square(xf[i]));
+    BENCH("power_int", od[i] = xd[i]*xd[i]*xd[i], of[i] = flint_power_int(xf[i], 3));
+    BENCH("power", od[i] = pow(xd[i], yd[i]), of[i] = flint_power(xf[i], yf[i]));
+    BENCH("sqrt", od[i] = sqrt(xd[i]), of[i] = flint_sqrt(xf[i]));
+    BENCH("cbrt", od[i] = cbrt(xd[i]), of[i] = flint_cbrt(xf[i]));
+    BENCH("hypot", od[i] = hypot(xd[i], yd[i]), of[i] = flint_hypot(xf[i], yf[i]));
+    BENCH("exp", od[i] = exp(xd[i]), of[i] = flint_exp(xf[i]));
+    BENCH("expm1", od[i] = expm1(xd[i]), of[i] = flint_expm1(xf[i]));
+    BENCH("log", od[i] = log(xd[i]), of[i] = flint_log(xf[i]));
+    BENCH("log1p", od[i] = log1p(xd[i]), of[i] = flint_log1p(xf[i]));
+    BENCH("sin", od[i] = sin(xd[i]), of[i] = flint_sin(xf[i]));
+    BENCH("cos", od[i] = cos(xd[i]), of[i] = flint_cos(xf[i]));
+    BENCH("tan", od[i] = tan(xd[i]), of[i] = flint_tan(xf[i]));
+    BENCH("asin", od[i] = asin(zd[i]), of[i] = flint_asin(zf[i]));
+    BENCH("atan", od[i] = atan(xd[i]), of[i] = flint_atan(xf[i]));
+    BENCH("atan2", od[i] = atan2(yd[i], xd[i]), of[i] = flint_atan2(yf[i], xf[i]));
+    BENCH("sinh", od[i] = sinh(xd[i]), of[i] = flint_sinh(xf[i]));
+    BENCH("tanh", od[i] = tanh(xd[i]), of[i] = flint_tanh(xf[i]));
+    BENCH("atanh", od[i] = atanh(zd[i]), of[i] = flint_atanh(zf[i]));
+    free(xd); free(yd); free(zd); free(od);
+    free(xf); free(yf); free(zf); free(of);
+    free(ob);
+    return sink == 0.123 ? 2 : 0;
+}
@@ -24,9 +24,27 @@ because 'why not?'
 # You should have received a copy of the GNU General Public License along with
 # numpy-flint. If not, see <https://www.gnu.org/licenses/>.
 
+import os
+import sys
 from setuptools import setup, Extension
 import numpy as np
 
+define_macros = []
+extra_compile_args = []
+# The vector kernels can only use the sqrt instructions if sqrt does not set errno
+if sys.platform != 'win32':
+    extra_compile_args.append('-fno-math-errno')
+    # Fused multiply-adds would change the tracked values of the vector kernels
+    extra_compile_args.append('-ffp-contract=off')
+# Optionally compute the interval boundaries with hardware directed rounding instead
+# of nextafter, the compiler must then not assume round-to-nearest
+if os.environ.get('NUMPY_FLINT_DIRECTED_ROUNDING', '0') not in ('', '0'):
+    define_macros.append(('FLINT_DIRECTED_ROUNDING', None))
+    if sys.platform == 'win32':
+        extra_compile_args.append('/fp:strict')
+    else:
+        extra_compile_args.append('-frounding-math')
+
 setup_args = dict(
     ext_modules = [
         Extension(
@@ -34,10 +52,14 @@ setup_args = dict(
             sources=['src/flint/numpy_flint.c'],
             depends=[
                 'src/flint/flint.h',
+                'src/flint/flint_simd.h',
+                'src/flint/flint_soa.h',
                 'src/flint/numpy_flint.h',
                 'src/flint/numpy_flint.c',
             ],
             include_dirs=[np.get_include()],
+            define_macros=define_macros,
+            extra_compile_args=extra_compile_args,
         )
     ]
 )
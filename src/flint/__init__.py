@@ -17,7 +17,24 @@ A python/NumPy interface for rounded FLoating point INTervals or flints.
 # You should have received a copy of the GNU General Public License along with
 # numpy-flint. If not, see <https://www.gnu.org/licenses/>.
 
-from .numpy_flint import flint
+import ast
+import functools
+import mmap
+import os
+import pickle
+import struct
+import sys
+from concurrent.futures import ThreadPoolExecutor
+
+import numpy as np
+
+from .numpy_flint import flint, flint32, rounding_mode, simd, set_num_threads, get_num_threads
+from .numpy_flint import from_bounds, fma, set_stats, reset_stats
+from . import numpy_flint
+
+# A forked child only keeps the thread that called fork, so restart the worker pool
+if hasattr(os, 'register_at_fork'):
+    os.register_at_fork(after_in_child=numpy_flint._after_fork)
 
 __version__ = "0.3.4"
 
@@ -25,3 +42,395 @@ def get_include() -> str:
     """Return the directory with the 'flint.h' header file"""
     import os
     return os.path.dirname(__file__)
+
+def stats():
+    """Return the flint performance counters
+
+    The counters are off by default, since they add a little work to every ufunc loop
+    and cast. Turn them on with ``set_stats(True)`` or by setting the ``FLINT_STATS``
+    environment variable to 1 before importing flint, and zero them with
+    :func:`reset_stats`. The result is a dict with the keys
+
+    * ``'loops'``: for each ufunc loop that has run, a dict with its number of
+      ``'calls'``, ``'elements'``, and ``'seconds'``. The loops are named after the flint
+      functions, with an ``f32_`` prefix for the flint32 loops and a ``mixed`` part for
+      the loops with a float64 argument.
+    * ``'casts'``: for each cast that has run, named after the c types like
+      ``'double->flint'``, a dict with its number of ``'calls'`` and ``'elements'``.
+    * ``'eps'``: a histogram of the widths ``b - a`` of the flint and flint32 results of
+      the ufunc loops, the same as the ``eps`` property. The keys are the lower edges
+      of the bins, which go up to twice their edge, with 0 for the zero widths and
+      infinity for the infinite and nan widths.
+    """
+    loops, casts, widths = numpy_flint._get_stats()
+    edges = [0.0] + [2.0**(i - 1075) for i in range(1, len(widths) - 1)] + [float('inf')]
+    return {
+        'loops': {name: {'calls': c, 'elements': n, 'seconds': t} for name, c, n, t in loops},
+        'casts': {name.replace('npy_', ''): {'calls': c, 'elements': n}
+                  for name, c, n in casts},
+        'eps': {edges[i]: count for i, count in enumerate(widths) if count},
+    }
+
+def components(arr):
+    """Return float64 views (a, b, v) of the lower bounds, upper bounds, and tracked
+    values of a flint array
+
+    The views share the memory of the flint array, so nothing is copied and writing
+    to a view changes the flints.
+    """
+    return tuple(numpy_flint._component_view(arr, offset) for offset in (0, 8, 16))
+
+def from_components(a, b, v=None, copy=None):
+    """Make a flint array from arrays of lower bounds, upper bounds, and tracked values
+
+    If `a`, `b`, and `v` are the views of one flint array, like the ones from
+    :func:`components`, the result shares their memory unless `copy` is True. Otherwise
+    the values are copied into a new flint array, which raises a ValueError if `copy`
+    is False. If `v` is not given the tracked values are the midpoints of the
+    intervals.
+    """
+    if v is not None and copy is not True and all(isinstance(x, np.ndarray) for x in (a, b, v)):
+        view = numpy_flint._flint_view(a, b, v)
+        if view is not None:
+            return view
+    if copy is False:
+        raise ValueError("The arrays are not the parts of a flint array, so they must be copied")
+    return from_bounds(a, b, v)
+
+def _record_dtype(dtype, byteorder='='):
+    """Return the structured dtype with the same memory layout as flints or flint32s"""
+    f = np.dtype(np.float32 if np.dtype(dtype) == np.dtype(flint32) else np.float64)
+    f = f.newbyteorder(byteorder)
+    return np.dtype([('a', f), ('b', f), ('v', f)])
+
+def as_records(arr):
+    """Return a structured view of a flint or flint32 array with the fields 'a', 'b',
+    and 'v'
+
+    The view shares the memory of the array. Unlike the flint dtype, the structured
+    dtype is understood by NumPy's file formats, so ``np.save(file, as_records(arr))``
+    writes the raw records, and :func:`from_records` turns them back into flints.
+    """
+    arr = np.asarray(arr)
+    return arr.view(_record_dtype(arr.dtype))
+
+def from_records(rec):
+    """Return a flint or flint32 array from a structured array with the fields 'a',
+    'b', and 'v', such as one made by :func:`as_records` or read back with ``np.load``
+
+    The array is a view of the records if they are in the native byte order, and a
+    byte swapped copy otherwise. Records with float32 fields give a flint32 array. Array
+    subclasses are kept, so the records of a ``np.memmap`` give a ``np.memmap``.
+    """
+    rec = np.asanyarray(rec)
+    if rec.dtype.names != ('a', 'b', 'v'):
+        raise ValueError("expected a structured array with the fields 'a', 'b', and 'v'")
+    dtype = flint32 if rec.dtype['v'].itemsize == 4 else flint
+    return rec.astype(_record_dtype(dtype), copy=False).view(dtype)
+
+# The header of the byte format: a magic string, the format version, the dtype (0 for
+# flint, 1 for flint32), the encoding (0 for raw records, 1 for offsets), and the
+# number of dimensions, followed by the shape as little endian int64s.
+_BYTES_MAGIC = b'FLNT'
+_BYTES_HEADER = struct.Struct('<4sBBBB')
+_BYTES_ENCODINGS = ('raw', 'offsets')
+# The 'offsets' encoding of a flint
+_OFFSETS_DTYPE = np.dtype([('v', '<f8'), ('da', '<f4'), ('db', '<f4')])
+
+def _round_down(x, dtype):
+    """Round x to the largest value of dtype that is not larger than x"""
+    y = x.astype(dtype)
+    return np.where(y > x, np.nextafter(y, dtype.type(-np.inf)), y)
+
+def _round_up(x, dtype):
+    """Round x to the smallest value of dtype that is not smaller than x"""
+    y = x.astype(dtype)
+    return np.where(y < x, np.nextafter(y, dtype.type(np.inf)), y)
+
+def to_bytes(arr, encoding='raw'):
+    """Serialize a flint or flint32 array into a compact bytes object
+
+    The bytes are a short header with the dtype and shape, followed by the data. With
+    the 'raw' encoding the data is the little endian records, so :func:`from_bytes`
+    gives back the identical array. The 'offsets' encoding of flint arrays stores the
+    tracked value as a float64 and the offsets ``a-v`` and ``b-v`` as float32s, which
+    is 16 bytes instead of 24 per flint. The offsets are rounded outward, so the decoded
+    intervals may be slightly wider but always contain the original ones.
+    """
+    arr = np.asarray(arr)
+    if arr.dtype not in (np.dtype(flint), np.dtype(flint32)):
+        raise TypeError("expected a flint or flint32 array")
+    if encoding not in _BYTES_ENCODINGS:
+        raise ValueError(f"encoding must be one of {_BYTES_ENCODINGS}")
+    kind = int(arr.dtype == np.dtype(flint32))
+    if kind and encoding == 'offsets':
+        raise ValueError("the offsets encoding is only for flint arrays")
+    header = _BYTES_HEADER.pack(_BYTES_MAGIC, 1, kind, _BYTES_ENCODINGS.index(encoding),
+                                arr.ndim)
+    header += np.asarray(arr.shape, dtype='<i8').tobytes()
+    rec = as_records(arr).astype(_record_dtype(arr.dtype, '<'), copy=False)
+    if encoding == 'raw':
+        return header + rec.tobytes()
+    a, b, v = (rec[name].astype(np.float64) for name in 'abv')
+    out = np.empty(arr.shape, dtype=_OFFSETS_DTYPE)
+    out['v'] = v
+    with np.errstate(invalid='ignore'):
+        da = np.where(a == v, 0.0, a - v)
+        db = np.where(b == v, 0.0, b - v)
+    out['da'] = _round_down(np.nextafter(da, -np.inf), np.dtype(np.float32))
+    out['db'] = _round_up(np.nextafter(db, np.inf), np.dtype(np.float32))
+    return header + out.tobytes()
+
+def from_bytes(data):
+    """Read a flint or flint32 array serialized with :func:`to_bytes`
+
+    For the 'raw' encoding on a little endian machine, the array is a read-only view of
+    the data without any copy.
+    """
+    data = memoryview(data).cast('B')
+    magic, version, kind, encoding, ndim = _BYTES_HEADER.unpack_from(data)
+    if magic != _BYTES_MAGIC or version != 1:
+        raise ValueError("not a serialized flint array")
+    shape = tuple(int(n) for n in np.frombuffer(data, '<i8', ndim, _BYTES_HEADER.size))
+    offset = _BYTES_HEADER.size + 8*ndim
+    count = int(np.prod(shape, dtype=np.int64))
+    dtype = flint32 if kind else flint
+    if _BYTES_ENCODINGS[encoding] == 'raw':
+        rec = np.frombuffer(data, _record_dtype(dtype, '<'), count, offset)
+        return from_records(rec).reshape(shape)
+    rec = np.frombuffer(data, _OFFSETS_DTYPE, count, offset).reshape(shape)
+    v = rec['v'].astype(np.float64)
+    da = rec['da'].astype(np.float64)
+    db = rec['db'].astype(np.float64)
+    out = np.empty(shape, dtype=_record_dtype(flint))
+    with np.errstate(invalid='ignore'):
+        out['a'] = np.nextafter(v + da, -np.inf)
+        out['b'] = np.nextafter(v + db, np.inf)
+    out['v'] = v
+    # An infinite tracked value loses the finite bound, so use the widest one instead
+    known = ~np.isnan(v) & ~np.isnan(da) & ~np.isnan(db)
+    out['a'][np.isnan(out['a']) & known] = -np.inf
+    out['b'][np.isnan(out['b']) & known] = np.inf
+    return out.view(flint)
+
+def _from_buffer(buffer, dtype, shape):
+    """Rebuild a flint or flint32 array from its raw memory, used by :class:`Pickler`"""
+    return np.frombuffer(buffer, dtype=np.uint8).view(dtype).reshape(shape)
+
+class Pickler(pickle.Pickler):
+    """A pickler that can hand the memory of flint and flint32 arrays out-of-band
+
+    NumPy can not export the memory of an array with a custom dtype as a buffer, so
+    with protocol 5 the regular pickler still copies flint arrays into the pickle. This
+    pickler hands over the records of C contiguous flint and flint32 arrays as a
+    :class:`pickle.PickleBuffer` instead, so that a ``buffer_callback`` can send them
+    without any copies. The pickles are read with the regular ``pickle.loads``.
+    """
+
+    def __init__(self, file, protocol=None, **kwargs):
+        super().__init__(file, protocol, **kwargs)
+        if protocol is None:
+            protocol = pickle.DEFAULT_PROTOCOL
+        self._out_of_band = protocol < 0 or protocol >= 5
+
+    def reducer_override(self, obj):
+        if (self._out_of_band and type(obj) is np.ndarray and
+                obj.dtype in (np.dtype(flint), np.dtype(flint32)) and
+                obj.flags.c_contiguous):
+            buffer = pickle.PickleBuffer(obj.reshape(-1).view(np.uint8))
+            return _from_buffer, (buffer, obj.dtype.type, obj.shape)
+        return NotImplemented
+
+def open_memmap(filename, mode='r+', dtype=flint, shape=None):
+    """Open a .npy file of flint or flint32 records as a memory mapped array
+
+    The file holds the structured records of :func:`as_records`, so it is a regular
+    .npy file with a header that records the byte order and shape. The mode is one of
+    'r', 'r+', 'w+', or 'c', as for ``np.memmap``, and a new file made with 'w+' needs
+    the dtype and shape. The flint ufunc loops do not need the python interpreter, so
+    they work directly on the mapped pages. A file in the other byte order can only be
+    opened with mode 'r' or 'c', which reads it into memory.
+    """
+    if mode == 'w+':
+        rec = np.lib.format.open_memmap(filename, mode=mode, dtype=_record_dtype(dtype),
+                                        shape=shape)
+    else:
+        rec = np.lib.format.open_memmap(filename, mode=mode)
+    if rec.dtype.names != ('a', 'b', 'v'):
+        raise ValueError(f"{filename} does not contain flint records")
+    if mode == 'r+' and not rec.dtype.isnative:
+        raise ValueError(f"{filename} is not in the native byte order, open it with mode 'r'")
+    return from_records(rec)
+
+# The number of bytes of each input array in a block for every thread, small enough
+# that the temporaries of a block stay in the cache
+_BLOCK_BYTES = 1 << 20
+
+def _touch(arrays):
+    """Read one byte from every page of the arrays, so that mapped pages are loaded"""
+    for x in arrays:
+        if x.size and x.flags.c_contiguous:
+            np.bitwise_or.reduce(x.reshape(-1).view(np.uint8)[::mmap.PAGESIZE])
+
+def _blocks(arrays, block_size):
+    """Yield the start and blocks of rows of the arrays, while the pages of the next
+    block are read in on another thread"""
+    n = len(arrays[0])
+    if any(x.ndim == 0 or len(x) != n for x in arrays):
+        raise ValueError("the arrays must all have the same length")
+    if block_size is None:
+        row_bytes = sum(x[:1].nbytes for x in arrays)
+        block_size = max(1, _BLOCK_BYTES*get_num_threads()//max(row_bytes, 1))
+    with ThreadPoolExecutor(1) as pool:
+        ahead = None
+        for start in range(0, n, block_size):
+            stop = start + block_size
+            if ahead is not None:
+                ahead.result()
+            ahead = None
+            if stop < n:
+                ahead = pool.submit(_touch, [x[stop:stop+block_size] for x in arrays])
+            yield start, [x[start:stop] for x in arrays]
+
+def apply_blocks(func, *arrays, out=None, block_size=None):
+    """Apply a function to arrays along their first axis in blocks of rows
+
+    The function can be a ufunc or any function of arrays that works row by row, such
+    as ``lambda x, y: np.sqrt(x*x + y*y)``. Working in blocks keeps the temporaries of
+    the function small, and for memory mapped arrays, such as those from
+    :func:`open_memmap`, only a few blocks of the file are in memory at any time. The
+    results are written into `out`, which can also be a memory mapped array, or into a
+    new array. The blocks are `block_size` rows, by default about a megabyte of each
+    array for every thread set with :func:`set_num_threads`.
+    """
+    arrays = [np.asanyarray(x) for x in arrays]
+    for start, block in _blocks(arrays, block_size):
+        result = np.asanyarray(func(*block))
+        if out is None:
+            out = np.empty((len(arrays[0]),) + result.shape[1:], dtype=result.dtype)
+        out[start:start+len(result)] = result
+    if out is None:
+        return func(*arrays)
+    return out
+
+def reduce_blocks(ufunc, arr, block_size=None):
+    """Reduce an array along its first axis with a ufunc, such as ``np.add``, in blocks
+    of rows
+
+    Each block is reduced with ``ufunc.reduce`` and the partial results are combined
+    with the ufunc, so a memory mapped array is read once, a block at a time. The
+    blocks are the same as for :func:`apply_blocks`.
+    """
+    arr = np.asanyarray(arr)
+    acc = None
+    for _, (block,) in _blocks([arr], block_size):
+        part = ufunc.reduce(block, axis=0)
+        acc = part if acc is None else ufunc(acc, part)
+    if acc is None:
+        return ufunc.reduce(arr, axis=0)
+    return acc
+
+# The operators and functions of the fused expressions, by their expression names
+_EVALUATE_BINOPS = {ast.Add: 'add', ast.Sub: 'subtract', ast.Mult: 'multiply',
+                    ast.Div: 'divide', ast.Pow: 'power', ast.Mod: 'remainder',
+                    ast.FloorDiv: 'floor_divide'}
+_EVALUATE_UNARYOPS = {ast.USub: 'negative', ast.UAdd: 'positive'}
+_EVALUATE_FUNCS = {name: name for name in numpy_flint._evaluate_ops[2:]}
+_EVALUATE_FUNCS.update({'abs': 'absolute', 'true_divide': 'divide', 'arctan2': 'atan2',
+                        'mod': 'remainder'})
+_EVALUATE_FUNCS.update({'arc'+name[1:]: name for name in
+                        ('asin', 'acos', 'atan', 'asinh', 'acosh', 'atanh')})
+_EVALUATE_ARITY = {name: 2 for name in _EVALUATE_BINOPS.values()}
+_EVALUATE_ARITY.update({'hypot': 2, 'atan2': 2, 'minimum': 2, 'maximum': 2, 'fmin': 2,
+                        'fmax': 2, 'fmod': 2, 'fma': 3})
+
+def _literal(node):
+    """Return the value of a number literal node, or None"""
+    if isinstance(node, ast.Constant):
+        value = node.value
+    elif isinstance(node, getattr(ast, 'Num', ())):
+        value = node.n
+    else:
+        return None
+    return value if type(value) in (int, float) else None
+
+@functools.lru_cache(maxsize=256)
+def _compile(ex):
+    """Compile an expression into a fused expression program and the variable names
+    and 1-tuples of constants that it loads"""
+    ops = {name: i for i, name in enumerate(numpy_flint._evaluate_ops)}
+    program = []
+    inputs = []
+
+    def load(key):
+        if key not in inputs:
+            inputs.append(key)
+        program.extend((ops['load'], inputs.index(key)))
+
+    def visit(node):
+        if isinstance(node, ast.BinOp) and type(node.op) in _EVALUATE_BINOPS:
+            visit(node.left)
+            # Integer powers use the outward-rounded repeated squaring of power_int
+            n = node.right
+            sign = 1
+            if isinstance(n, ast.UnaryOp) and type(n.op) in _EVALUATE_UNARYOPS:
+                sign = -1 if isinstance(n.op, ast.USub) else 1
+                n = n.operand
+            n = _literal(n) if isinstance(node.op, ast.Pow) else None
+            if type(n) is int and -2**63 <= sign*n < 2**63:
+                program.extend((ops['power_int'], sign*n))
+            else:
+                visit(node.right)
+                program.extend((ops[_EVALUATE_BINOPS[type(node.op)]], 0))
+        elif isinstance(node, ast.UnaryOp) and type(node.op) in _EVALUATE_UNARYOPS:
+            visit(node.operand)
+            program.extend((ops[_EVALUATE_UNARYOPS[type(node.op)]], 0))
+        elif (isinstance(node, ast.Call) and isinstance(node.func, ast.Name) and
+              node.func.id in _EVALUATE_FUNCS and not node.keywords):
+            name = _EVALUATE_FUNCS[node.func.id]
+            if len(node.args) != _EVALUATE_ARITY.get(name, 1):
+                raise TypeError(f"{node.func.id} takes {_EVALUATE_ARITY.get(name, 1)} arguments")
+            for arg in node.args:
+                visit(arg)
+            program.extend((ops[name], 0))
+        elif isinstance(node, ast.Name):
+            load(node.id)
+        elif _literal(node) is not None:
+            load((_literal(node),))
+        else:
+            raise ValueError(f"unsupported {type(node).__name__} in the expression {ex!r}")
+
+    visit(ast.parse(ex.strip(), mode='eval').body)
+    return tuple(program), tuple(inputs)
+
+def evaluate(ex, local_dict=None, global_dict=None, out=None):
+    """Evaluate an expression of flint arrays in a single pass
+
+    The expression is a string, such as ``"sqrt(x*x + y*y)*k"``, with the arithmetic
+    operators, number literals, and the flint ufuncs by name, such as ``sqrt``,
+    ``arctan2``, ``hypot``, or ``fma``. Integer powers like ``x**2`` use the
+    outward-rounded repeated squaring of integer powers. The names are looked up in
+    `local_dict` and `global_dict`, by default the caller's local and global variables,
+    and are broadcast against each other and converted to flints.
+
+    Instead of making a full size temporary array for every operation, the whole
+    expression is run over small blocks of elements that stay in the cache, so the
+    inputs are only read once and the result only written once. The result is
+    written into `out` if given, or a new flint array.
+    """
+    program, inputs = _compile(ex)
+    if local_dict is None or global_dict is None:
+        frame = sys._getframe(1)
+        local_dict = frame.f_locals if local_dict is None else local_dict
+        global_dict = frame.f_globals if global_dict is None else global_dict
+    args = []
+    for key in inputs:
+        if not isinstance(key, str):
+            args.append(flint(key[0]))
+        elif key in local_dict:
+            args.append(local_dict[key])
+        elif key in global_dict:
+            args.append(global_dict[key])
+        else:
+            raise NameError(f"name {key!r} is not defined")
+    return numpy_flint._evaluate(program, tuple(args), out)
@@ -26,7 +26,12 @@ extern "C" {
 #endif
 
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
+#ifdef FLINT_DIRECTED_ROUNDING
+#include <fenv.h>
+#endif
 
 // Get the max of 4 inputs
 static inline double max4( double a, double b, double c, double d) {
@@ -42,6 +47,27 @@ static inline double min4( double a, double b, double c, double d) {
     return a<b?a:b;
 }
 
+// Get the next larger double, identical to nextafter(x, INFINITY) but written without
+// branches or a library call so that loops using it can be vectorized
+static inline double flint_nextup(double x) {
+    uint64_t i, j;
+    memcpy(&i, &x, sizeof(double));
+    // Step the bit pattern away from zero for positive values and towards zero for
+    // negative values
+    j = i + 1 - ((i >> 63) << 1);
+    // Both +0 and -0 go to the smallest positive subnormal
+    j = (x == 0.0) ? 1 : j;
+    // NaN and +inf stay put, isless is used since it never raises the invalid flag
+    j = isless(x, INFINITY) ? j : i;
+    memcpy(&x, &j, sizeof(double));
+    return x;
+}
+
+// Get the next smaller double, identical to nextafter(x, -INFINITY)
+static inline double flint_nextdown(double x) {
+    return -flint_nextup(-x);
+}
+
 
 /**
  * Rounded floating point interval with tracked value
@@ -147,8 +173,8 @@ static inline flint float_to_flint(float f) {
  */
 static inline flint double_to_flint(double f) {
     return (flint) {
-        nextafter(f, -INFINITY),
-        nextafter(f, INFINITY),
+        flint_nextdown(f),
+        flint_nextup(f),
         f
     };
 }
@@ -289,6 +315,92 @@ static inline int flint_gt(flint f1, flint f2) {
         f1.a > f2.b;
 }
 
+/**
+ * The comparisons with a double first turn the double into a flint.
+ */
+#define FLINT_COMPARE_SCALAR(name) \
+static inline int flint_##name##_scalar(flint f, double s) { \
+    return flint_##name(f, double_to_flint(s)); \
+} \
+static inline int flint_scalar_##name(double s, flint f) { \
+    return flint_##name(double_to_flint(s), f); \
+}
+FLINT_COMPARE_SCALAR(eq)
+FLINT_COMPARE_SCALAR(ne)
+FLINT_COMPARE_SCALAR(le)
+FLINT_COMPARE_SCALAR(lt)
+FLINT_COMPARE_SCALAR(ge)
+FLINT_COMPARE_SCALAR(gt)
+
+/**
+ * The smaller or larger of two flints can not be picked with the comparisons when the
+ * intervals overlap, so the minimum and maximum are taken for each boundary and the
+ * tracked value separately. The result encloses the minimum or maximum of any two
+ * values in the intervals. If either flint is NaN the result is NaN.
+ */
+
+/**
+ * .. _flint_minimum:
+ */
+static inline flint flint_minimum(flint f1, flint f2) {
+    flint _f;
+    if (flint_isnan(f1) || flint_isnan(f2)) {
+        double nan = NAN;
+        _f.a = nan; _f.b = nan; _f.v = nan;
+    } else {
+        _f.a = (f1.a < f2.a) ? f1.a : f2.a;
+        _f.b = (f1.b < f2.b) ? f1.b : f2.b;
+        _f.v = (f1.v < f2.v) ? f1.v : f2.v;
+    }
+    return _f;
+}
+
+/**
+ * .. _flint_maximum:
+ */
+static inline flint flint_maximum(flint f1, flint f2) {
+    flint _f;
+    if (flint_isnan(f1) || flint_isnan(f2)) {
+        double nan = NAN;
+        _f.a = nan; _f.b = nan; _f.v = nan;
+    } else {
+        _f.a = (f1.a > f2.a) ? f1.a : f2.a;
+        _f.b = (f1.b > f2.b) ? f1.b : f2.b;
+        _f.v = (f1.v > f2.v) ? f1.v : f2.v;
+    }
+    return _f;
+}
+
+/**
+ * The fmin and fmax functions are the same as minimum and maximum, except that a flint
+ * with NaN components is ignored in favor of the other one. The result is only NaN if
+ * both are.
+ *
+ * .. _flint_fmin:
+ */
+static inline flint flint_fmin(flint f1, flint f2) {
+    if (flint_isnan(f1) && !flint_isnan(f2)) {
+        return f2;
+    }
+    if (flint_isnan(f2) && !flint_isnan(f1)) {
+        return f1;
+    }
+    return flint_minimum(f1, f2);
+}
+
+/**
+ * .. _flint_fmax:
+ */
+static inline flint flint_fmax(flint f1, flint f2) {
+    if (flint_isnan(f1) && !flint_isnan(f2)) {
+        return f2;
+    }
+    if (flint_isnan(f2) && !flint_isnan(f1)) {
+        return f1;
+    }
+    return flint_maximum(f1, f2);
+}
+
 /**
  * .. _Arithmetic:
  *
@@ -309,6 +421,67 @@ static inline int flint_gt(flint f1, flint f2) {
  * that the result lies somewhere in the new rounded interval.
  */
 
+/**
+ * .. _DirectedRounding:
+ *
+ * Directed rounding
+ * ^^^^^^^^^^^^^^^^^
+ *
+ * By default the boundaries of the result are computed with the standard round to
+ * nearest mode, and then pushed outward by one ULP with ``nextafter``. If the header
+ * is compiled with the ``FLINT_DIRECTED_ROUNDING`` macro defined, the four basic
+ * arithmetic operations instead compute the boundaries with the hardware rounding
+ * mode set toward positive infinity. The lower boundary uses the identity
+ *
+ * .. math::
+ *
+ *     \text{RD}(x \circ y) = -\text{RU}((-x) \circ' y),
+ *
+ * so a single rounding mode serves both boundaries. Each boundary then costs a single
+ * floating point instruction, and the resulting intervals are as tight as possible.
+ * The tracked value is still computed with round to nearest.
+ *
+ * The ``flint_OPNAME_ru`` functions only compute the boundaries and expect the caller
+ * to have already set the rounding mode upward with :ref:`flint_round_upward
+ * <flint_round_upward>`. That lets a loop over many values switch the rounding mode
+ * once instead of once per element. The standard ``flint_OPNAME`` functions switch
+ * the rounding mode themselves.
+ *
+ * .. note::
+ *
+ *     Code that changes the rounding mode must be compiled so that the compiler does
+ *     not assume round to nearest, ``-frounding-math`` for gcc and clang or
+ *     ``/fp:strict`` for msvc.
+ */
+#ifdef FLINT_DIRECTED_ROUNDING
+#ifndef FE_UPWARD
+#error "FLINT_DIRECTED_ROUNDING requires a platform with the FE_UPWARD rounding mode"
+#endif
+
+/**
+ * .. _flint_round_upward:
+ */
+static inline int flint_round_upward(void) {
+    int mode = fegetround();
+    fesetround(FE_UPWARD);
+    return mode;
+}
+
+/**
+ * .. _flint_round_restore:
+ */
+static inline void flint_round_restore(int mode) {
+    fesetround(mode);
+}
+
+// Pass a flint through memory so that the compiler can not move any arithmetic on it
+// across a change in the rounding mode.
+static inline flint flint_round_fence(flint f) {
+    volatile flint _f = f;
+    return _f;
+}
+#endif // FLINT_DIRECTED_ROUNDING
+
 /**
  * Unary operations
  * ^^^^^^^^^^^^^^^^
@@ -345,6 +518,29 @@ static inline flint flint_negative(flint f) {
  * """""""""""""""""""""""""
  */
 
+#ifdef FLINT_DIRECTED_ROUNDING
+/**
+ * .. _flint_add_ru:
+ */
+static inline void flint_add_ru(flint f1, flint f2, flint* f) {
+    f->a = -((-f1.a)-f2.a);
+    f->b = f1.b+f2.b;
+}
+
+/**
+ * .. _flint_add:
+ */
+static inline flint flint_add(flint f1, flint f2) {
+    flint _f;
+    volatile double v = f1.v+f2.v;
+    int mode = flint_round_upward();
+    flint_add_ru(flint_round_fence(f1), flint_round_fence(f2), &_f);
+    _f = flint_round_fence(_f);
+    flint_round_restore(mode);
+    _f.v = v;
+    return _f;
+}
+#else
 /**
  * .. _flint_add:
  */
@@ -356,14 +552,19 @@ static inline flint flint_add(flint f1, flint f2) {
     };
     return _f;
 }
+#endif
 
 /**
  * .. _flint_inplace_add:
  */
 static inline void flint_inplace_add(flint* f1, flint f2) {
+#ifdef FLINT_DIRECTED_ROUNDING
+    *f1 = flint_add(*f1, f2);
+#else
     f1->a = nextafter(f1->a + f2.a, -INFINITY);
     f1->b = nextafter(f1->b + f2.b, INFINITY);
     f1->v += f2.v;
+#endif
     return;
 }
 
@@ -394,6 +595,29 @@ static inline void flint_inplace_add_scalar(flint* f, double s) {
  * """"""""""""""""""""""""""""
  */
 
+#ifdef FLINT_DIRECTED_ROUNDING
+/**
+ * .. _flint_subtract_ru:
+ */
+static inline void flint_subtract_ru(flint f1, flint f2, flint* f) {
+    f->a = -(f2.b-f1.a);
+    f->b = f1.b-f2.a;
+}
+
+/**
+ * .. _flint_subtract:
+ */
+static inline flint flint_subtract(flint f1, flint f2) {
+    flint _f;
+    volatile double v = f1.v-f2.v;
+    int mode = flint_round_upward();
+    flint_subtract_ru(flint_round_fence(f1), flint_round_fence(f2), &_f);
+    _f = flint_round_fence(_f);
+    flint_round_restore(mode);
+    _f.v = v;
+    return _f;
+}
+#else
 /**
  * .. _flint_subtract:
  */
@@ -405,14 +629,19 @@ static inline flint flint_subtract(flint f1, flint f2) {
     };
     return _f;
 }
+#endif
 
 /**
  * .. _flint_inplace_subtract:
  */
 static inline void flint_inplace_subtract(flint* f1, flint f2) {
+#ifdef FLINT_DIRECTED_ROUNDING
+    *f1 = flint_subtract(*f1, f2);
+#else
     f1->a = nextafter(f1->a - f2.b, -INFINITY);
     f1->b = nextafter(f1->b - f2.a, INFINITY);
     f1->v -= f2.v;
+#endif
     return;
 }
 
@@ -442,6 +671,29 @@ static inline void flint_inplace_subtract_scalar(flint* f, double s) {
  * """""""""""""""""""""""""""""""
  */
 
+#ifdef FLINT_DIRECTED_ROUNDING
+/**
+ * .. _flint_multiply_ru:
+ */
+static inline void flint_multiply_ru(flint f1, flint f2, flint* f) {
+    f->a = -max4((-f1.a)*f2.a, (-f1.a)*f2.b, (-f1.b)*f2.a, (-f1.b)*f2.b);
+    f->b = max4(f1.a*f2.a, f1.a*f2.b, f1.b*f2.a, f1.b*f2.b);
+}
+
+/**
+ * .. _flint_mulitply:
+ */
+static inline flint flint_multiply(flint f1, flint f2) {
+    flint _f;
+    volatile double v = f1.v*f2.v;
+    int mode = flint_round_upward();
+    flint_multiply_ru(flint_round_fence(f1), flint_round_fence(f2), &_f);
+    _f = flint_round_fence(_f);
+    flint_round_restore(mode);
+    _f.v = v;
+    return _f;
+}
+#else
 /**
  * .. _flint_mulitply:
  */
@@ -455,30 +707,56 @@ static inline flint flint_multiply(flint f1, flint f2) {
     };
     return _f;
 }
+#endif
 
 /**
  * .. _flint_inplace_mulitply:
  */
 static inline void flint_inplace_multiply(flint* f1, flint f2) {
-    double _a = min4(f1->a*f2.a, f1->a*f2.b, f1->b*f2.a, f1->b*f2.b);
-    f1->b = max4(f1->a*f2.a, f1->a*f2.b, f1->b*f2.a, f1->b*f2.b);
-    f1->a = _a;
-    f1->v *= f2.v;
+    *f1 = flint_multiply(*f1, f2);
     return;
 }
 
 /**
- * .. _flint_scalar_mulitply:
+ * Most doubles become a flint whose interval is finite and does not contain zero, and
+ * then the sign of each boundary of the other flint is enough to pick which of the four
+ * products is the lower or upper boundary. The result is the same as the general
+ * multiplication.
+ *
+ * .. _flint_mulitply_scalar:
  */
-static inline flint flint_scalar_multiply(double s, flint f) {
-    return flint_multiply(double_to_flint(s), f);
+static inline flint flint_multiply_scalar(flint f, double s) {
+#ifndef FLINT_DIRECTED_ROUNDING
+    flint fs = double_to_flint(s);
+    if ((fs.a > 0.0 || fs.b < 0.0) && isfinite(fs.a) && isfinite(fs.b)) {
+        flint _f;
+        if (s < 0.0) {
+            // f*s = (-f)*(-s), and -s has the positive interval (-fs.b, -fs.a)
+            double a = f.a;
+            f.a = -f.b; f.b = -a;
+            a = fs.a;
+            fs.a = -fs.b; fs.b = -a;
+        }
+        _f.a = nextafter((f.a >= 0.0) ? f.a*fs.a : f.a*fs.b, -INFINITY);
+        _f.b = nextafter((f.b >= 0.0) ? f.b*fs.b : f.b*fs.a, INFINITY);
+        _f.v = f.v*s;
+        return _f;
+    }
+#endif
+    return flint_multiply(f, double_to_flint(s));
 }
 
 /**
- * .. _flint_mulitply_scalar:
+ * .. _flint_scalar_mulitply:
  */
-static inline flint flint_multiply_scalar(flint f, double s) {
-    return flint_multiply(f, double_to_flint(s));
+static inline flint flint_scalar_multiply(double s, flint f) {
+#ifndef FLINT_DIRECTED_ROUNDING
+    flint fs = double_to_flint(s);
+    if ((fs.a > 0.0 || fs.b < 0.0) && isfinite(fs.a) && isfinite(fs.b)) {
+        return flint_multiply_scalar(f, s);
+    }
+#endif
+    return flint_multiply(double_to_flint(s), f);
 }
 
 /**
@@ -493,6 +771,29 @@ static inline void flint_inplace_multiply_scalar(flint* f, double s) {
  * """""""""""""""""""""""""
  */
 
+#ifdef FLINT_DIRECTED_ROUNDING
+/**
+ * .. _flint_divide_ru:
+ */
+static inline void flint_divide_ru(flint f1, flint f2, flint* f) {
+    f->a = -max4((-f1.a)/f2.a, (-f1.a)/f2.b, (-f1.b)/f2.a, (-f1.b)/f2.b);
+    f->b = max4(f1.a/f2.a, f1.a/f2.b, f1.b/f2.a, f1.b/f2.b);
+}
+
+/**
+ * .. _flint_divide:
+ */
+static inline flint flint_divide(flint f1, flint f2) {
+    flint _f;
+    volatile double v = f1.v/f2.v;
+    int mode = flint_round_upward();
+    flint_divide_ru(flint_round_fence(f1), flint_round_fence(f2), &_f);
+    _f = flint_round_fence(_f);
+    flint_round_restore(mode);
+    _f.v = v;
+    return _f;
+}
+#else
 /**
  * .. _flint_divide:
  */
@@ -506,22 +807,42 @@ static inline flint flint_divide(flint f1, flint f2) {
     };
     return _f;
 }
+#endif
 
 /**
  * .. _flint_inplace_divide:
  */
 static inline void flint_inplace_divide(flint* f1, flint f2) {
-    double _a = min4(f1->a/f2.a, f1->a/f2.b, f1->b/f2.a, f1->b/f2.b);
-    f1->b = max4(f1->a/f2.a, f1->a/f2.b, f1->b/f2.a, f1->b/f2.b);
-    f1->a = _a;
-    f1->v /= f2.v;
+    *f1 = flint_divide(*f1, f2);
     return;
 }
 
 /**
+ * As with multiplication, the quotient boundaries can be picked from the signs when
+ * neither the double nor the divisor contains zero.
+ *
  * .. _flint_scalar_divide:
  */
 static inline flint flint_scalar_divide(double s, flint f) {
+#ifndef FLINT_DIRECTED_ROUNDING
+    flint fs = double_to_flint(s);
+    if ((fs.a > 0.0 || fs.b < 0.0) && isfinite(fs.a) && isfinite(fs.b) &&
+        (f.a > 0.0 || f.b < 0.0)) {
+        flint _f;
+        double v = s/f.v;
+        if (s < 0.0) {
+            // s/f = (-s)/(-f)
+            double a = f.a;
+            f.a = -f.b; f.b = -a;
+            a = fs.a;
+            fs.a = -fs.b; fs.b = -a;
+        }
+        _f.a = nextafter((f.a > 0.0) ? fs.a/f.b : fs.b/f.b, -INFINITY);
+        _f.b = nextafter((f.a > 0.0) ? fs.b/f.a : fs.a/f.a, INFINITY);
+        _f.v = v;
+        return _f;
+    }
+#endif
     return flint_divide(double_to_flint(s), f);
 }
 
@@ -529,6 +850,24 @@ static inline flint flint_scalar_divide(double s, flint f) {
  * .. _flint_divide_scalar:
  */
 static inline flint flint_divide_scalar(flint f, double s) {
+#ifndef FLINT_DIRECTED_ROUNDING
+    flint fs = double_to_flint(s);
+    if ((fs.a > 0.0 || fs.b < 0.0) && isfinite(fs.a) && isfinite(fs.b)) {
+        flint _f;
+        double v = f.v/s;
+        if (s < 0.0) {
+            // f/s = (-f)/(-s)
+            double a = f.a;
+            f.a = -f.b; f.b = -a;
+            a = fs.a;
+            fs.a = -fs.b; fs.b = -a;
+        }
+        _f.a = nextafter((f.a >= 0.0) ? f.a/fs.b : f.a/fs.a, -INFINITY);
+        _f.b = nextafter((f.b >= 0.0) ? f.b/fs.a : f.b/fs.b, INFINITY);
+        _f.v = v;
+        return _f;
+    }
+#endif
     return flint_divide(f, double_to_flint(s));
 }
 
@@ -539,6 +878,104 @@ static inline void flint_inplace_divide_scalar(flint* f, double s) {
     flint_inplace_divide(f, double_to_flint(s));
 }
 
+/**
+ * Fused multiply-add
+ * """"""""""""""""""
+ *
+ * The fused multiply-add ``x*y + z`` rounds each product of the boundaries only once,
+ * together with the boundary of ``z``, using the c99 ``fma`` function. That gives a
+ * single widening per term instead of one for the product and another for the sum,
+ * so loops like dot products and Horner's scheme for polynomials get both faster and
+ * tighter intervals. The tracked value is also computed with ``fma``.
+ */
+
+#ifdef FLINT_DIRECTED_ROUNDING
+/**
+ * .. _flint_fma_ru:
+ */
+static inline void flint_fma_ru(flint x, flint y, flint z, flint* f) {
+    f->a = -max4(fma(-x.a, y.a, -z.a), fma(-x.a, y.b, -z.a),
+                 fma(-x.b, y.a, -z.a), fma(-x.b, y.b, -z.a));
+    f->b = max4(fma(x.a, y.a, z.b), fma(x.a, y.b, z.b),
+                fma(x.b, y.a, z.b), fma(x.b, y.b, z.b));
+}
+
+/**
+ * .. _flint_fma:
+ */
+static inline flint flint_fma(flint x, flint y, flint z) {
+    flint _f;
+    volatile double v = fma(x.v, y.v, z.v);
+    int mode = flint_round_upward();
+    flint_fma_ru(flint_round_fence(x), flint_round_fence(y), flint_round_fence(z), &_f);
+    _f = flint_round_fence(_f);
+    flint_round_restore(mode);
+    _f.v = v;
+    return _f;
+}
+#else
+/**
+ * .. _flint_fma:
+ */
+static inline flint flint_fma(flint x, flint y, flint z) {
+    flint _f = {
+        flint_nextdown(min4(fma(x.a, y.a, z.a), fma(x.a, y.b, z.a),
+                            fma(x.b, y.a, z.a), fma(x.b, y.b, z.a))),
+        flint_nextup(max4(fma(x.a, y.a, z.b), fma(x.a, y.b, z.b),
+                          fma(x.b, y.a, z.b), fma(x.b, y.b, z.b))),
+        fma(x.v, y.v, z.v)
+    };
+    return _f;
+}
+#endif
+
+/**
+ * .. _flint_inplace_fma:
+ */
+static inline void flint_inplace_fma(flint* f, flint x, flint y) {
+    *f = flint_fma(x, y, *f);
+}
+
+/**
+ * .. _flint_madd:
+ *
+ * Loops that only use the fused multiply-add to go faster, like dot products, use
+ * ``flint_inplace_madd`` instead. It is the fused multiply-add when the c99 ``fma``
+ * is a hardware instruction (``FP_FAST_FMA``), and the product followed by the sum
+ * otherwise, since a libm ``fma`` in software would be slower than both.
+ */
+#ifdef FP_FAST_FMA
+#define FLINT_FAST_FMA 1
+#else
+#define FLINT_FAST_FMA 0
+#endif
+
+#ifdef FLINT_DIRECTED_ROUNDING
+/**
+ * .. _flint_madd_ru:
+ */
+static inline void flint_madd_ru(flint x, flint y, flint z, flint* f) {
+#if FLINT_FAST_FMA
+    flint_fma_ru(x, y, z, f);
+#else
+    flint p;
+    flint_multiply_ru(x, y, &p);
+    flint_add_ru(z, p, f);
+#endif
+}
+#endif
+
+/**
+ * .. _flint_inplace_madd:
+ */
+static inline void flint_inplace_madd(flint* f, flint x, flint y) {
+#if FLINT_FAST_FMA
+    *f = flint_fma(x, y, *f);
+#else
+    *f = flint_add(*f, flint_multiply(x, y));
+#endif
+}
+
 /**
  * .. _MathFunctions:
  *
@@ -654,16 +1091,140 @@ static inline void flint_inplace_divide_scalar(flint* f, double s) {
  */
 
 
+// Round the sum x + y down (up) with an error free sum, so it only steps outwards when
+// the round to nearest sum is on the wrong side of the exact one. The step is picked
+// with a bit mask, since the side is as good as random.
+static inline double flint_sum_down(double x, double y) {
+    double s = x + y;
+    double t = s - x;
+    double n = flint_nextdown(s);
+    uint64_t i, j, m = -(uint64_t) ((x - (s - t)) + (y - t) < 0.0);
+    memcpy(&i, &s, sizeof(double));
+    memcpy(&j, &n, sizeof(double));
+    i = (i & ~m) | (j & m);
+    memcpy(&s, &i, sizeof(double));
+    return s;
+}
+
+static inline double flint_sum_up(double x, double y) {
+    double s = x + y;
+    double t = s - x;
+    double n = flint_nextup(s);
+    uint64_t i, j, m = -(uint64_t) ((x - (s - t)) + (y - t) > 0.0);
+    memcpy(&i, &s, sizeof(double));
+    memcpy(&j, &n, sizeof(double));
+    i = (i & ~m) | (j & m);
+    memcpy(&s, &i, sizeof(double));
+    return s;
+}
+
 /**
- * .. _foo:
+ * Most intervals are only a few ULPs wide, so the monotonic functions are evaluated
+ * once at the tracked value and enclosed with the mean value form,
+ *
+ * .. math::
+ *
+ *     f([a,b]) \subseteq f(v) + [-m(v-a), m(b-v)],
+ *
+ * where :math:`m` bounds the derivative over the interval. Each function has a slope
+ * function that finds :math:`m` from the tracked value, the function value, and the
+ * larger distance :math:`w` to a boundary, or returns -1 if it can not. Wide intervals,
+ * a tracked value outside the interval, tiny or non-finite values, or a missing bound
+ * fall back to evaluating both boundaries.
  */
+// The widest distance from the tracked value to a boundary using the mean value form
+#define FLINT_MEAN_VALUE_MAX 0x1p-26
+// The smallest function value using the mean value form
+#define FLINT_MEAN_VALUE_MIN 0x1p-900
+
+// The largest change m*d of an increasing function for a distance d from the tracked
+// value, with room for the rounding of the distance and the product. A distance that
+// underflows in the product is covered by a tiny floor.
+static inline double flint_mean_value_step(double m, double d) {
+    double p = m*d;
+    return (d != 0.0 && p < 0x1p-1000) ? 0x1p-1000 : p + 4e-16*p;
+}
+
+// Enclose an increasing function with value y at v and derivative bound m. Two steps
+// cover the 2 ULP error of y.
+static inline flint flint_mean_value(flint f, double y, double m) {
+    flint _f;
+    _f.a = flint_sum_down(flint_nextdown(flint_nextdown(y)),
+                          -flint_mean_value_step(m, f.v-f.a));
+    _f.b = flint_sum_up(flint_nextup(flint_nextup(y)),
+                        flint_mean_value_step(m, f.b-f.v));
+    _f.v = y;
+    return _f;
+}
+
+// Bounds on the derivatives over [v-w, v+w], using |(ln f')'| <= c so that
+// f'(x) <= f'(v)*exp(c*w) <= f'(v)*(1 + 2*c*w) for w <= FLINT_MEAN_VALUE_MAX. The
+// 3e-15 terms cover the libm error of y and the rounding.
+static inline double flint_cbrt_slope(double v, double y, double w) {
+    // 1/(3 cbrt(x)^2), which only holds away from zero
+    return (w <= 0.25*fabs(v)) ? (1.0 + 2.0*w/fabs(v) + 3e-15)/(3.0*y*y) : -1.0;
+}
+
+static inline double flint_exp_slope(double v, double y, double w) {
+    (void) v;
+    return y*(1.0 + 2.0*w + 3e-15);
+}
+
+static inline double flint_exp2_slope(double v, double y, double w) {
+    (void) v;
+    return 0.6931471805599454*y*(1.0 + 2.0*w + 3e-15);
+}
+
+static inline double flint_expm1_slope(double v, double y, double w) {
+    (void) v;
+    return (y + (1.0 + 3e-15))*(1.0 + 2.0*w + 3e-15);
+}
+
+static inline double flint_erf_slope(double v, double y, double w) {
+    (void) y;
+    // 2/sqrt(pi) exp(-x^2), with c = 2(|v|+w)
+    return 1.1283791670955127*exp(-v*v)*
+           (1.0 + 4.0*(fabs(v)+w)*w + 3e-15*(1.0 + v*v));
+}
+
+static inline double flint_atan_slope(double v, double y, double w) {
+    (void) y;
+    return (1.0 + 2.0*w + 3e-15)/(1.0 + v*v);
+}
+
+static inline double flint_sinh_slope(double v, double y, double w) {
+    (void) v;
+    // cosh(v) = sqrt(1 + sinh(v)^2)
+    return sqrt(1.0 + y*y)*(1.0 + 2.0*w + 3e-15);
+}
+
+static inline double flint_tanh_slope(double v, double y, double w) {
+    (void) v;
+    // 1 - tanh(x)^2 with c = 2
+    return ((1.0 - fabs(y))*(1.0 + fabs(y)) + 3e-15)*(1.0 + 4.0*w + 3e-15);
+}
+
+static inline double flint_asinh_slope(double v, double y, double w) {
+    (void) y;
+    return (1.0 + 2.0*w + 3e-15)/sqrt(1.0 + v*v);
+}
+
 #define FLINT_MONOTONIC(fname) \
 static inline flint flint_##fname(flint f) { \
-    flint _f = { \
-        nextafter(nextafter(fname(f.a), -INFINITY), -INFINITY), \
-        nextafter(nextafter(fname(f.b), INFINITY), INFINITY), \
-        fname(f.v) \
-    }; \
+    double y = fname(f.v); \
+    double w = (f.v-f.a > f.b-f.v) ? f.v-f.a : f.b-f.v; \
+    double m = -1.0; \
+    flint _f; \
+    if (f.a <= f.v && f.v <= f.b && w <= FLINT_MEAN_VALUE_MAX && \
+        fabs(y) >= FLINT_MEAN_VALUE_MIN) { \
+        m = flint_##fname##_slope(f.v, y, w); \
+    } \
+    if (m >= 0.0 && m < INFINITY) { \
+        return flint_mean_value(f, y, m); \
+    } \
+    _f.a = nextafter(nextafter(fname(f.a), -INFINITY), -INFINITY); \
+    _f.b = nextafter(nextafter(fname(f.b), INFINITY), INFINITY); \
+    _f.v = y; \
     return _f; \
 }
 
@@ -701,6 +1262,101 @@ static inline void flint_inplace_power(flint* f1, flint f2) {
     }
 }
 
+/**
+ * Powers with an integer exponent use exponentiation by squaring on the magnitudes of
+ * the boundaries instead of ``pow`` at the four corners. Each product of the lower
+ * (upper) magnitude is pushed one ULP down (up). Odd powers keep the sign of the
+ * interval, and even powers of an interval that spans zero have a lower bound of zero.
+ * The tracked value is ``pow(v, n)`` so it matches the power of a double.
+ */
+// Products of non-negative values rounded down and up
+static inline double flint_mul_down(double x, double y) {
+    double p = x*y;
+    return (p == 0.0) ? 0.0 : flint_nextdown(p);
+}
+
+static inline double flint_mul_up(double x, double y) {
+    double p = x*y;
+    return (x == 0.0 || y == 0.0) ? 0.0 : flint_nextup(p);
+}
+
+// Set the boundaries of f to the bounds of [lo, hi]^n for 0 <= lo <= hi and n > 0
+static inline void flint_power_bounds(double lo, double hi, uint64_t n, flint* f) {
+    int first = 1;
+    while (n) {
+        if (n & 1) {
+            f->a = first ? lo : flint_mul_down(f->a, lo);
+            f->b = first ? hi : flint_mul_up(f->b, hi);
+            first = 0;
+        }
+        n >>= 1;
+        if (n) {
+            lo = flint_mul_down(lo, lo);
+            hi = flint_mul_up(hi, hi);
+        }
+    }
+}
+
+static inline flint flint_power_int(flint f, int64_t n) {
+    uint64_t m = (n < 0) ? -((uint64_t) n) : (uint64_t) n;
+    flint p = {1.0, 1.0, 1.0};
+    flint _f;
+    double t;
+    if (n == 0) {
+        return p;
+    }
+    p.v = pow(f.v, (double) n);
+    if (isnan(f.a) || isnan(f.b) || isnan(p.v)) {
+        double nan = NAN;
+        p.a = nan; p.b = nan; p.v = nan;
+        return p;
+    }
+    if (f.a >= 0.0) {
+        flint_power_bounds(f.a, f.b, m, &p);
+    } else if (f.b <= 0.0) {
+        flint_power_bounds(-f.b, -f.a, m, &p);
+        if (m & 1) {
+            t = p.a; p.a = -p.b; p.b = -t;
+        }
+    } else if (m & 1) {
+        // The interval spans zero, so the bounds are the powers of the ends
+        flint_power_bounds(0.0, -f.a, m, &_f);
+        flint_power_bounds(0.0, f.b, m, &p);
+        p.a = -_f.b;
+    } else {
+        flint_power_bounds(0.0, (-f.a > f.b) ? -f.a : f.b, m, &p);
+    }
+    if (n > 0) {
+        return p;
+    }
+    // Negative powers are the reciprocal, which is unbounded if the power is zero
+    _f.v = p.v;
+    if (p.a > 0.0 || p.b < 0.0) {
+        _f.a = flint_nextdown(1.0/p.b);
+        _f.b = flint_nextup(1.0/p.a);
+    } else if (p.a == 0.0 && p.b > 0.0) {
+        _f.a = flint_nextdown(1.0/p.b);
+        _f.b = INFINITY;
+    } else if (p.b == 0.0 && p.a < 0.0) {
+        _f.a = -INFINITY;
+        _f.b = flint_nextup(1.0/p.a);
+    } else {
+        _f.a = -INFINITY;
+        _f.b = INFINITY;
+    }
+    return _f;
+}
+
+static inline void flint_inplace_power_int(flint* f, int64_t n) {
+    *f = flint_power_int(*f, n);
+}
+
+static inline flint flint_square(flint f) {
+    flint _f = flint_power_int(f, 2);
+    _f.v = f.v*f.v;
+    return _f;
+}
+
 static inline flint flint_absolute(flint f) {
     flint _f = f;
     if (f.b < 0.0) { // interval is all negative - so invert
@@ -816,62 +1472,146 @@ static inline flint flint_erfc(flint f) {
 }
 
 
-static inline flint flint_sin(flint f) {
-    int n = (int) floor(f.a/FLINT_2PI.a);
-    double da = f.a-n*FLINT_2PI.a;
-    double db = f.b-n*FLINT_2PI.a;
-    double sa = sin(f.a);
-    double sb = sin(f.b);
+/**
+ * The sine and cosine of narrow flints are evaluated with a first order Taylor
+ * expansion around the tracked value,
+ *
+ * .. math::
+ *
+ *     \sin(v+d) \in \sin(v) + \cos(v) [a-v, b-v] + [-w^2/2, w^2/2],
+ *
+ * where :math:`w` is the larger distance from the tracked value to a boundary. The
+ * expansion holds whether or not the interval contains an extremum, so there is nothing
+ * to test, and it only needs the function and its derivative at the tracked value. The
+ * derivative does not have to be as accurate as the function, so away from the extrema
+ * it comes from :math:`|\cos(v)| = \sqrt{1-\sin(v)^2}` with the sign set by the quadrant
+ * of :math:`v`, and each flint costs a single call to libm. The remainder term is only
+ * used while it is below the rounding error of the result. Wider intervals evaluate
+ * both boundaries, and the sign of the derivative at both ends tells if the interval
+ * contains an extremum.
+ */
+// The widest distance from the tracked value to a boundary using the Taylor expansion
+#define FLINT_TRIG_TAYLOR_MAX 0x1p-26
+// The range of tracked values that use the Taylor expansion, the quadrant is trusted
+// below the upper limit and no distance underflows in the products above the lower one
+#define FLINT_TRIG_QUADRANT_MIN 0x1p-500
+#define FLINT_TRIG_QUADRANT_MAX 0x1p20
+// The smallest derivative that is computed from the value of the function
+#define FLINT_TRIG_SLOPE_MIN 0x1p-20
+// 2/pi rounded to a double
+#define FLINT_2_OVER_PI 0.6366197723675814
+
+// Enclose f(v+d) = y + dy*d + R for d in [a-v, b-v], where y is the libm value of the
+// function at v, dy the derivative at v from flint_trig_slope, and |R| <= w^2/2. Two
+// steps cover the 2 ULP error of y, and e holds the remainder, the error of the
+// derivative, and the rounding of the distances and the products. The remainder is
+// bounded by w times the largest w so that e never underflows.
+static inline flint flint_trig_taylor(flint f, double y, double dy, double w) {
+    double pa = dy*(f.a-f.v);
+    double pb = dy*(f.b-f.v);
+    double lo = (pa < pb) ? pa : pb;
+    double hi = (pa > pb) ? pa : pb;
+    double k = (fabs(dy) >= 0.5) ? 2.0*y*y : 1.0/FLINT_TRIG_SLOPE_MIN;
+    double e = (1.5e-15*(k + fabs(dy)) + FLINT_TRIG_TAYLOR_MAX)*w;
     flint _f;
-    _f.a = nextafter(nextafter((sa<sb?sa:sb), -INFINITY), -INFINITY);
-    _f.b = nextafter(nextafter((sa>sb?sa:sb), INFINITY), INFINITY);
-    if (da <= FLINT_PI_2.a && db > FLINT_PI_2.a) {
-        _f.b = 1.0;
-    } else if (da <= 3*FLINT_PI_2.a) {
-        if (db > 3*FLINT_PI_2.a) {
-            _f.a = -1.0;
-        }
-        if (db > 5*FLINT_PI_2.a) {
-            _f.b = 1.0;
-        }
-    } else {
-        if (db > 5*FLINT_PI_2.a) {
-            _f.b = 1.0;
-        }
-        if (db > 7*FLINT_PI_2.a) {
-            _f.a = -1.0;
-        }
-    }
-    _f.v = sin(f.v);
+    _f.a = flint_sum_down(flint_nextdown(flint_nextdown(y)), lo - (e + 1.5e-16*fabs(lo)));
+    _f.b = flint_sum_up(flint_nextup(flint_nextup(y)), hi + (e + 1.5e-16*fabs(hi)));
+    _f.a = (_f.a < -1.0) ? -1.0 : _f.a;
+    _f.b = (_f.b > 1.0) ? 1.0 : _f.b;
+    _f.v = y;
     return _f;
 }
 
-static inline flint flint_cos(flint f) {
-    int n = (int) floor(f.a/FLINT_2PI.a);
-    double da = f.a-n*FLINT_2PI.a;
-    double db = f.b-n*FLINT_2PI.a;
-    double ca = cos(f.a);
-    double cb = cos(f.b);
-    flint _f;
-    _f.a = nextafter(nextafter((ca<cb?ca:cb), -INFINITY), -INFINITY);
-    _f.b = nextafter(nextafter((ca>cb?ca:cb), INFINITY), INFINITY);
-    if (da <= FLINT_PI.a && db > FLINT_PI.a) {
-        _f.a = -1.0;
-        if (db > FLINT_2PI.a) {
-            _f.b = 1.0;
-        }
-    } else {
-        if (db > FLINT_2PI.a) {
-            _f.b = 1.0;
-        }
-        if (db > 3*FLINT_PI.a) {
-            _f.a = -1.0;
-        }
+// The derivative of sin (cos) at v from the value y = sin(v) (cos(v)), or 0 if it is too
+// small or v is out of the range of FLINT_TRIG_QUADRANT_MIN and MAX. The magnitude is sqrt(1-y^2), and the
+// parity of floor((v*2/pi + shift)/2) gives the sign, with shift 1 for sin (a cos
+// slope) and 2 for cos (a -sin slope). The error of the result is at most
+// 1e-15*(y^2/|dy| + |dy|).
+static inline double flint_trig_slope(double v, double y, double shift) {
+    double dy = sqrt((1.0-y)*(1.0+y));
+    double t = 0.5*(v*FLINT_2_OVER_PI + shift);
+    int64_t q;
+    uint64_t i;
+    if (!(fabs(v) >= FLINT_TRIG_QUADRANT_MIN && fabs(v) <= FLINT_TRIG_QUADRANT_MAX &&
+          dy >= FLINT_TRIG_SLOPE_MIN)) {
+        return 0.0;
     }
-    _f.v = cos(f.v);
-    return _f;
+    q = (int64_t) t;
+    q -= (t < (double) q);
+    // Odd quadrants flip the sign bit
+    memcpy(&i, &dy, sizeof(double));
+    i ^= ((uint64_t) q & 1) << 63;
+    memcpy(&dy, &i, sizeof(double));
+    return dy;
+}
+
+// Set the boundaries to the bounds of the two values at the ends of an interval, then
+// extend them to 1 or -1 if the derivative changes sign from positive to negative or
+// from negative to positive. The interval must be shorter than pi, so that it holds at
+// most one zero of the derivative.
+static inline void flint_trig_ends(double ya, double yb, double dya, double dyb,
+                                   flint* f) {
+    double lo = nextafter(nextafter((ya < yb ? ya : yb), -INFINITY), -INFINITY);
+    double hi = nextafter(nextafter((ya > yb ? ya : yb), INFINITY), INFINITY);
+    f->a = (f->a < lo) ? f->a : lo;
+    f->b = (f->b > hi) ? f->b : hi;
+    if (dya >= 0.0 && dyb <= 0.0) {
+        f->b = 1.0;
+    }
+    if (dya <= 0.0 && dyb >= 0.0) {
+        f->a = -1.0;
+    }
+}
+
+// Evaluate the bounds of sin (cos) from the ends of an interval. Intervals shorter than
+// 3 are checked as one piece, up to 6 they are split in half, and anything wider covers a
+// full period. The result is NaN for a NaN boundary, or a single infinite value.
+#define FLINT_TRIG_WIDE(name, deriv) \
+static inline flint flint_##name##_wide(flint f) { \
+    flint _f = {INFINITY, -INFINITY, 0.0}; \
+    double w = f.b-f.a; \
+    double m = f.a + 0.5*w; \
+    if (isnan(w)) { \
+        double nan = NAN; \
+        _f.a = nan; _f.b = nan; \
+    } else if (!(w < 6.0)) { \
+        _f.a = -1.0; _f.b = 1.0; \
+    } else if (w < 3.0) { \
+        flint_trig_ends(name(f.a), name(f.b), deriv(f.a), deriv(f.b), &_f); \
+    } else { \
+        flint_trig_ends(name(f.a), name(m), deriv(f.a), deriv(m), &_f); \
+        flint_trig_ends(name(m), name(f.b), deriv(m), deriv(f.b), &_f); \
+    } \
+    return _f; \
 }
 
+static inline double flint_neg_sin(double x) {
+    return -sin(x);
+}
+
+FLINT_TRIG_WIDE(sin, cos)
+FLINT_TRIG_WIDE(cos, flint_neg_sin)
+
+// Define sin (cos) of a flint, with the quadrant shift for flint_trig_slope. Narrow
+// intervals with a usable derivative use the Taylor expansion, everything else is
+// evaluated from the boundaries.
+#define FLINT_TRIG(name, shift) \
+static inline flint flint_##name(flint f) { \
+    double y = name(f.v); \
+    double w = (f.v-f.a > f.b-f.v) ? f.v-f.a : f.b-f.v; \
+    double dy = flint_trig_slope(f.v, y, shift); \
+    flint _f; \
+    if (w <= FLINT_TRIG_TAYLOR_MAX && dy != 0.0) { \
+        return flint_trig_taylor(f, y, dy, w); \
+    } \
+    _f = flint_##name##_wide(f); \
+    _f.v = y; \
+    return _f; \
+}
+
+FLINT_TRIG(sin, 1.0)
+FLINT_TRIG(cos, 2.0)
+
 static inline flint flint_tan(flint f) {
     double ta = tan(f.a);
     double tb = tan(f.b);
@@ -1004,6 +1744,25 @@ static inline flint flint_atan2(flint fy, flint fx) {
     return _f;
 }
 
+/**
+ * The power, hypot, and atan2 functions with a double first turn the double into a
+ * flint.
+ */
+#define FLINT_BINARY_SCALAR(name) \
+static inline flint flint_##name##_scalar(flint f, double s) { \
+    return flint_##name(f, double_to_flint(s)); \
+} \
+static inline flint flint_scalar_##name(double s, flint f) { \
+    return flint_##name(double_to_flint(s), f); \
+}
+FLINT_BINARY_SCALAR(power)
+FLINT_BINARY_SCALAR(hypot)
+FLINT_BINARY_SCALAR(atan2)
+
+static inline void flint_inplace_power_scalar(flint* f, double s) {
+    flint_inplace_power(f, double_to_flint(s));
+}
+
 FLINT_MONOTONIC(sinh)
 
 static inline flint flint_cosh(flint f) {
@@ -1066,7 +1825,279 @@ static inline flint flint_atanh(flint f) {
         }
     }
     return _f;
-} 
+}
+
+/**
+ * .. _Rounding:
+ *
+ * Rounding and remainders
+ * -----------------------
+ *
+ * The ``floor``, ``ceil``, ``trunc``, and ``rint`` functions are monotonic, and the
+ * result for a double is always an exactly representable integer. So the flint
+ * versions just apply the function to the boundaries and the tracked value without
+ * stepping outwards. The ``rint`` function rounds to the nearest integer using the
+ * current rounding mode, which is the default round to nearest outside of the
+ * arithmetic loops.
+ *
+ * The ``fmod`` and ``remainder`` functions are not continuous. If every quotient in the
+ * interval :math:`x/y` has the same integer part :math:`n`, then the remainder is just
+ * :math:`x - ny` for every value in the interval, and it can be found with the flint
+ * arithmetic. Otherwise the interval jumps across a discontinuity, and the result is
+ * bounded by the range of possible remainders: :math:`|r| < |y|` with the sign of
+ * :math:`x` for ``fmod``, and :math:`0 \le r/y < 1` for ``remainder``. The ``fmod``
+ * function follows the c99 ``fmod``, and the ``remainder`` and ``floor_divide``
+ * functions follow the numpy ``remainder`` and ``floor_divide`` ufuncs, with the
+ * remainder having the sign of the divisor. Their tracked values satisfy divmod
+ * together, so ``(x//y)*y + x%y`` tracks ``x`` as closely as it does in numpy. Dividing
+ * by an interval that is exactly zero returns NaN, and so does the tracked value
+ * whenever the tracked value of the divisor is zero.
+ *
+ * .. c:function:: static inline flint flint_FUNCNAME(flint fa, ...)
+ *
+ * Functions
+ * ^^^^^^^^^
+ *
+ * ``floor``
+ * ``ceil``
+ * ``trunc``
+ * ``rint``
+ * ``fmod``
+ * ``remainder``
+ * ``floor_divide``
+ * ``modf``
+ */
+#define FLINT_ROUNDING(name) \
+static inline flint flint_##name(flint f) { \
+    flint _f = {name(f.a), name(f.b), name(f.v)}; \
+    return _f; \
+}
+FLINT_ROUNDING(floor)
+FLINT_ROUNDING(ceil)
+FLINT_ROUNDING(trunc)
+FLINT_ROUNDING(rint)
+
+// Intersect an interval with the range [lo, hi] of values it is known to lie in
+static inline flint flint_clip_range(flint f, double lo, double hi) {
+    f.a = (f.a < lo) ? lo : f.a;
+    f.b = (f.b > hi) ? hi : f.b;
+    return f;
+}
+
+// The interval x - n*y for an integer n. A zero quotient leaves x as is, which also
+// keeps an infinite boundary of y from turning into 0*inf = NaN.
+static inline flint flint_remove_multiple(flint x, flint y, double n) {
+    flint _n = {n, n, n};
+    if (n == 0.0) {
+        return x;
+    }
+    return flint_subtract(x, flint_multiply(_n, y));
+}
+
+static inline flint flint_fmod(flint x, flint y) {
+    double m, t;
+    flint q, _f;
+    if (flint_isnan(x) || flint_isnan(y) || isinf(x.v) || (y.a == 0.0 && y.b == 0.0)) {
+        double nan = NAN;
+        _f.a = nan; _f.b = nan; _f.v = nan;
+        return _f;
+    }
+    // |r| < max|y| and |r| <= |x| with the sign of x
+    m = (-y.a > y.b) ? -y.a : y.b;
+    if (x.a >= 0.0) {
+        _f.a = 0.0;
+        _f.b = (x.b < m) ? x.b : m;
+    } else if (x.b <= 0.0) {
+        _f.a = (x.a > -m) ? x.a : -m;
+        _f.b = 0.0;
+    } else {
+        _f.a = (x.a > -m) ? x.a : -m;
+        _f.b = (x.b < m) ? x.b : m;
+    }
+    _f.v = fmod(x.v, y.v);
+    // The same truncated quotient for the whole interval means no discontinuity
+    if (y.a > 0.0 || y.b < 0.0) {
+        q = flint_divide(x, y);
+        t = trunc(q.a);
+        if (t == trunc(q.b)) {
+            q = flint_remove_multiple(x, y, t);
+            q.v = _f.v;
+            _f = flint_clip_range(q, _f.a, _f.b);
+        }
+    }
+    return _f;
+}
+
+static inline flint flint_remainder(flint x, flint y) {
+    double t;
+    flint q, _f;
+    if (flint_isnan(x) || flint_isnan(y) || isinf(x.v) || (y.a == 0.0 && y.b == 0.0)) {
+        double nan = NAN;
+        _f.a = nan; _f.b = nan; _f.v = nan;
+        return _f;
+    }
+    // 0 <= r/y < 1, and r <= x for x and y with the same sign
+    if (y.a >= 0.0) {
+        _f.a = 0.0;
+        _f.b = (x.a >= 0.0 && x.b < y.b) ? x.b : y.b;
+    } else if (y.b <= 0.0) {
+        _f.a = (x.b <= 0.0 && x.a > y.a) ? x.a : y.a;
+        _f.b = 0.0;
+    } else {
+        _f.a = y.a;
+        _f.b = y.b;
+    }
+    // The tracked value follows the numpy remainder
+    if (y.v == 0.0) {
+        _f.v = NAN;
+    } else {
+        t = fmod(x.v, y.v);
+        if (t != 0.0 && ((t < 0.0) != (y.v < 0.0))) {
+            t += y.v;
+        }
+        _f.v = (t == 0.0) ? copysign(0.0, y.v) : t;
+    }
+    // The same floored quotient for the whole interval means no discontinuity
+    if (y.a > 0.0 || y.b < 0.0) {
+        q = flint_divide(x, y);
+        t = floor(q.a);
+        if (t == floor(q.b)) {
+            q = flint_remove_multiple(x, y, t);
+            q.v = _f.v;
+            _f = flint_clip_range(q, _f.a, _f.b);
+        }
+    }
+    return _f;
+}
+
+static inline flint flint_floor_divide(flint x, flint y) {
+    double t, d;
+    flint _f;
+    if (flint_isnan(x) || flint_isnan(y) || (y.a == 0.0 && y.b == 0.0)) {
+        double nan = NAN;
+        _f.a = nan; _f.b = nan; _f.v = nan;
+        return _f;
+    }
+    if (y.a <= 0.0 && y.b >= 0.0) {
+        // The quotients are unbounded in both directions
+        _f.a = -INFINITY;
+        _f.b = INFINITY;
+    } else {
+        _f = flint_floor(flint_divide(x, y));
+    }
+    // The tracked value follows the numpy floor_divide, so that it pairs with the
+    // tracked value of the remainder: divide out the remainder, then floor
+    if (y.v == 0.0) {
+        _f.v = NAN;
+    } else {
+        t = fmod(x.v, y.v);
+        d = (x.v - t)/y.v;
+        if (t != 0.0 && ((t < 0.0) != (y.v < 0.0))) {
+            d -= 1.0;
+        }
+        if (d != 0.0) {
+            t = floor(d);
+            _f.v = (d - t > 0.5) ? t + 1.0 : t;
+        } else {
+            _f.v = copysign(0.0, x.v/y.v);
+        }
+    }
+    return _f;
+}
+
+FLINT_BINARY_SCALAR(fmod)
+FLINT_BINARY_SCALAR(remainder)
+FLINT_BINARY_SCALAR(floor_divide)
+
+static inline flint flint_modf(flint f, flint* ipart) {
+    flint _f;
+    double t;
+    *ipart = flint_trunc(f);
+    if (flint_isnan(f)) {
+        double nan = NAN;
+        _f.a = nan; _f.b = nan; _f.v = nan;
+        return _f;
+    }
+    if (ipart->a == ipart->b && !isinf(ipart->a)) {
+        // The fractional part x - n is exact for every value in the interval
+        _f.a = f.a - ipart->a;
+        _f.b = f.b - ipart->a;
+    } else if (f.a >= 0.0) {
+        _f.a = 0.0;
+        _f.b = (f.b < 1.0) ? f.b : 1.0;
+    } else if (f.b <= 0.0) {
+        _f.a = (f.a > -1.0) ? f.a : -1.0;
+        _f.b = 0.0;
+    } else {
+        _f.a = (f.a > -1.0) ? f.a : -1.0;
+        _f.b = (f.b < 1.0) ? f.b : 1.0;
+    }
+    _f.v = modf(f.v, &t);
+    return _f;
+}
+
+/**
+ * .. _flint32:
+ *
+ * Single precision flints
+ * -----------------------
+ *
+ * The flint32 keeps the lower and upper bounds and the tracked value as 32 bit floats
+ * (c floats), which halves the memory of a flint. The math is not done in single
+ * precision, instead a flint32 is widened to a flint, evaluated with the flint
+ * functions above, and then narrowed back.
+ *
+ * Widening is exact, since every float is also a double. Narrowing rounds the lower
+ * bound down and the upper bound up to the nearest float, so the narrowed interval
+ * always contains the wide one. The tracked value is rounded to the nearest float.
+ */
+typedef struct {
+    /**
+     * The lower bound
+     */
+    float a;
+    /**
+     * The upper bound
+     */
+    float b;
+    /**
+     * The tracked value
+     */
+    float v;
+} flint32;
+
+// Round a double to the largest float that is not larger than it
+static inline float flint_float_down(double x) {
+    float f = (float) x;
+    return ((double) f > x) ? nextafterf(f, -INFINITY) : f;
+}
+
+// Round a double to the smallest float that is not smaller than it
+static inline float flint_float_up(double x) {
+    float f = (float) x;
+    return ((double) f < x) ? nextafterf(f, INFINITY) : f;
+}
+
+/**
+ * .. _flint32_to_flint:
+ */
+static inline flint flint32_to_flint(flint32 f) {
+    return (flint) {(double) f.a, (double) f.b, (double) f.v};
+}
+
+/**
+ * .. _flint_to_flint32:
+ */
+static inline flint32 flint_to_flint32(flint f) {
+    return (flint32) {flint_float_down(f.a), flint_float_up(f.b), (float) f.v};
+}
+
+/**
+ * .. _float_to_flint32:
+ */
+static inline flint32 float_to_flint32(float f) {
+    return (flint32) {nextafterf(f, -INFINITY), nextafterf(f, INFINITY), f};
+}
 
 
 #ifdef __cplusplus
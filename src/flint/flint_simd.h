@@ -0,0 +1,601 @@
+/**
+ * Block kernels for arrays of flints written to be vectorized by the compiler
+ */
+// Copyright (c) 2023, Jef Wagner <jefwagner@gmail.com>
+//
+// This file is part of numpy-flint.
+//
+// Numpy-flint is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// Numpy-flint is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// numpy-flint. If not, see <https://www.gnu.org/licenses/>.
+//
+// This file is a template and is meant to be included once for every instruction set
+// that gets a copy of the kernels. Before each include define
+//
+//     FLINT_SIMD_NAME(name) - add the instruction set suffix to a kernel name
+//     FLINT_SIMD_TARGET     - the function attribute selecting the instruction set
+//     FLINT_SIMD_ISA        - a string naming the instruction set
+//     FLINT_SIMD_FMA        - optional, 1 if the instruction set has a hardware fused
+//                             multiply-add, defaults to FLINT_FAST_FMA
+//
+// Every kernel takes byte strides like a NumPy inner loop. It copies a block of flints
+// into separate arrays of lower bounds, upper bounds, and tracked values, evaluates the
+// operation with branch free loops of a fixed length over those arrays, and then
+// interleaves the results back into the output. Those loops are what the compiler
+// turns into vector instructions. The results are bit for bit the same as the scalar
+// functions in flint.h. An input can be the output itself, with the same stride, but
+// must not otherwise overlap the output, since a whole block is read before any of it
+// is written.
+#ifndef __FLINT_SIMD_H__
+#define __FLINT_SIMD_H__
+
+#include <stddef.h>
+#include <string.h>
+#include "flint.h"
+
+// The number of flints in one block
+#define FLINT_SIMD_BLOCK 128
+
+// Kernels that work on arrays from the caller promise the compiler that they do not
+// overlap, otherwise it would have to check at run time before vectorizing
+#ifdef _MSC_VER
+#define FLINT_SIMD_RESTRICT __restrict
+#else
+#define FLINT_SIMD_RESTRICT restrict
+#endif
+
+// Function signatures of the kernels
+typedef void (*flint_simd_unary_func)(const char* x, ptrdiff_t sx,
+                                      char* z, ptrdiff_t sz, ptrdiff_t n);
+typedef void (*flint_simd_binary_func)(const char* x, ptrdiff_t sx,
+                                       const char* y, ptrdiff_t sy,
+                                       char* z, ptrdiff_t sz, ptrdiff_t n);
+typedef void (*flint_simd_ternary_func)(const char* x, ptrdiff_t sx,
+                                        const char* y, ptrdiff_t sy,
+                                        const char* w, ptrdiff_t sw,
+                                        char* z, ptrdiff_t sz, ptrdiff_t n);
+typedef ptrdiff_t (*flint_simd_arg_func)(const flint* x, ptrdiff_t n);
+typedef void (*flint_simd_row_func)(flint x, const double* ya, const double* yb,
+                                    const double* yv, double* za, double* zb,
+                                    double* zv, ptrdiff_t n);
+
+// The full set of kernels for one instruction set
+typedef struct {
+    const char* isa;
+    flint_simd_binary_func add;
+    flint_simd_binary_func subtract;
+    flint_simd_binary_func multiply;
+    flint_simd_binary_func divide;
+    flint_simd_ternary_func madd;
+    flint_simd_binary_func minimum;
+    flint_simd_binary_func maximum;
+    flint_simd_binary_func fmin;
+    flint_simd_binary_func fmax;
+    flint_simd_binary_func eq;
+    flint_simd_binary_func ne;
+    flint_simd_binary_func lt;
+    flint_simd_binary_func le;
+    flint_simd_binary_func gt;
+    flint_simd_binary_func ge;
+    flint_simd_unary_func negative;
+    flint_simd_unary_func absolute;
+    flint_simd_unary_func sqrt;
+    flint_simd_unary_func floor;
+    flint_simd_unary_func ceil;
+    flint_simd_unary_func trunc;
+    flint_simd_unary_func rint;
+    flint_simd_arg_func argmin;
+    flint_simd_arg_func argmax;
+    flint_simd_row_func mul_row;
+    flint_simd_row_func madd_row;
+} flint_simd_kernels;
+
+// Split m flints into separate arrays, padding the rest of the block with ones so
+// that the fixed length loops never raise spurious floating point exceptions. Full
+// contiguous blocks get their own loop which the compiler can vectorize.
+static inline void flint_simd_load(const char* src, ptrdiff_t std, ptrdiff_t m,
+                                   double* a, double* b, double* v) {
+    ptrdiff_t j;
+    const flint* f = (const flint*) src;
+    if (std == sizeof(flint) && m == FLINT_SIMD_BLOCK) {
+        for (j=0; j<FLINT_SIMD_BLOCK; j++) {
+            a[j] = f[j].a;
+            b[j] = f[j].b;
+            v[j] = f[j].v;
+        }
+        return;
+    }
+    for (j=0; j<m; j++) {
+        f = (const flint*) (src + j*std);
+        a[j] = f->a;
+        b[j] = f->b;
+        v[j] = f->v;
+    }
+    for (; j<FLINT_SIMD_BLOCK; j++) {
+        a[j] = 1.0;
+        b[j] = 1.0;
+        v[j] = 1.0;
+    }
+}
+
+// Interleave the first m results of a block into the output flints
+static inline void flint_simd_store(char* dst, ptrdiff_t std, ptrdiff_t m,
+                                    const double* a, const double* b,
+                                    const double* v) {
+    ptrdiff_t j;
+    flint* f = (flint*) dst;
+    if (std == sizeof(flint) && m == FLINT_SIMD_BLOCK) {
+        for (j=0; j<FLINT_SIMD_BLOCK; j++) {
+            f[j].a = a[j];
+            f[j].b = b[j];
+            f[j].v = v[j];
+        }
+        return;
+    }
+    for (j=0; j<m; j++) {
+        f = (flint*) (dst + j*std);
+        f->a = a[j];
+        f->b = b[j];
+        f->v = v[j];
+    }
+}
+
+// Copy the first m boolean results of a block into the output
+static inline void flint_simd_store_bool(char* dst, ptrdiff_t std, ptrdiff_t m,
+                                         const unsigned char* c) {
+    ptrdiff_t j;
+    if (std == 1) {
+        memcpy(dst, c, m);
+        return;
+    }
+    for (j=0; j<m; j++) {
+        *((unsigned char*) (dst + j*std)) = c[j];
+    }
+}
+
+// Define a kernel for a unary operation with a flint result. The body is the inside of
+// a loop over j that reads xa[j], xb[j], xv[j] and writes za[j], zb[j], zv[j].
+#define FLINT_SIMD_UNARY(name, body) \
+FLINT_SIMD_TARGET static void FLINT_SIMD_NAME(name)(const char* x, ptrdiff_t sx, \
+                                                    char* z, ptrdiff_t sz, \
+                                                    ptrdiff_t n) { \
+    double xa[FLINT_SIMD_BLOCK], xb[FLINT_SIMD_BLOCK], xv[FLINT_SIMD_BLOCK]; \
+    double za[FLINT_SIMD_BLOCK], zb[FLINT_SIMD_BLOCK], zv[FLINT_SIMD_BLOCK]; \
+    ptrdiff_t i, j, m; \
+    for (i=0; i<n; i+=m) { \
+        m = (n-i < FLINT_SIMD_BLOCK) ? (n-i) : FLINT_SIMD_BLOCK; \
+        flint_simd_load(x, sx, m, xa, xb, xv); \
+        for (j=0; j<FLINT_SIMD_BLOCK; j++) { \
+            body \
+        } \
+        flint_simd_store(z, sz, m, za, zb, zv); \
+        x += m*sx; \
+        z += m*sz; \
+    } \
+}
+
+// Define a kernel for a binary operation with a flint result. The body reads both
+// xa[j], xb[j], xv[j] and ya[j], yb[j], yv[j].
+#define FLINT_SIMD_BINARY(name, body) \
+FLINT_SIMD_TARGET static void FLINT_SIMD_NAME(name)(const char* x, ptrdiff_t sx, \
+                                                    const char* y, ptrdiff_t sy, \
+                                                    char* z, ptrdiff_t sz, \
+                                                    ptrdiff_t n) { \
+    double xa[FLINT_SIMD_BLOCK], xb[FLINT_SIMD_BLOCK], xv[FLINT_SIMD_BLOCK]; \
+    double ya[FLINT_SIMD_BLOCK], yb[FLINT_SIMD_BLOCK], yv[FLINT_SIMD_BLOCK]; \
+    double za[FLINT_SIMD_BLOCK], zb[FLINT_SIMD_BLOCK], zv[FLINT_SIMD_BLOCK]; \
+    ptrdiff_t i, j, m; \
+    for (i=0; i<n; i+=m) { \
+        m = (n-i < FLINT_SIMD_BLOCK) ? (n-i) : FLINT_SIMD_BLOCK; \
+        flint_simd_load(x, sx, m, xa, xb, xv); \
+        flint_simd_load(y, sy, m, ya, yb, yv); \
+        for (j=0; j<FLINT_SIMD_BLOCK; j++) { \
+            body \
+        } \
+        flint_simd_store(z, sz, m, za, zb, zv); \
+        x += m*sx; \
+        y += m*sy; \
+        z += m*sz; \
+    } \
+}
+
+// Define a kernel for a ternary operation with a flint result. The body reads the
+// third input from wa[j], wb[j], wv[j].
+#define FLINT_SIMD_TERNARY(name, body) \
+FLINT_SIMD_TARGET static void FLINT_SIMD_NAME(name)(const char* x, ptrdiff_t sx, \
+                                                    const char* y, ptrdiff_t sy, \
+                                                    const char* w, ptrdiff_t sw, \
+                                                    char* z, ptrdiff_t sz, \
+                                                    ptrdiff_t n) { \
+    double xa[FLINT_SIMD_BLOCK], xb[FLINT_SIMD_BLOCK], xv[FLINT_SIMD_BLOCK]; \
+    double ya[FLINT_SIMD_BLOCK], yb[FLINT_SIMD_BLOCK], yv[FLINT_SIMD_BLOCK]; \
+    double wa[FLINT_SIMD_BLOCK], wb[FLINT_SIMD_BLOCK], wv[FLINT_SIMD_BLOCK]; \
+    double za[FLINT_SIMD_BLOCK], zb[FLINT_SIMD_BLOCK], zv[FLINT_SIMD_BLOCK]; \
+    ptrdiff_t i, j, m; \
+    for (i=0; i<n; i+=m) { \
+        m = (n-i < FLINT_SIMD_BLOCK) ? (n-i) : FLINT_SIMD_BLOCK; \
+        flint_simd_load(x, sx, m, xa, xb, xv); \
+        flint_simd_load(y, sy, m, ya, yb, yv); \
+        flint_simd_load(w, sw, m, wa, wb, wv); \
+        for (j=0; j<FLINT_SIMD_BLOCK; j++) { \
+            body \
+        } \
+        flint_simd_store(z, sz, m, za, zb, zv); \
+        x += m*sx; \
+        y += m*sy; \
+        w += m*sw; \
+        z += m*sz; \
+    } \
+}
+
+// Define a kernel for a comparison. The body sets the boolean c from the bounds of x and
+// y and the flag nan[j] that is set if any of the inputs is a NaN. Unlike the scalar
+// comparisons the ordered comparisons are not skipped for NaNs, so a first pass
+// replaces the NaN bounds with zero and the bodies use the quiet comparison macros
+// from math.h. The separate pass keeps the compiler from folding the replacement into
+// the comparisons, which either stops the vectorization or raises the invalid flag.
+#define FLINT_SIMD_COMPARE(name, body) \
+FLINT_SIMD_TARGET static void FLINT_SIMD_NAME(name)(const char* x, ptrdiff_t sx, \
+                                                    const char* y, ptrdiff_t sy, \
+                                                    char* z, ptrdiff_t sz, \
+                                                    ptrdiff_t n) { \
+    double xa[FLINT_SIMD_BLOCK], xb[FLINT_SIMD_BLOCK], xv[FLINT_SIMD_BLOCK]; \
+    double ya[FLINT_SIMD_BLOCK], yb[FLINT_SIMD_BLOCK], yv[FLINT_SIMD_BLOCK]; \
+    unsigned char nan[FLINT_SIMD_BLOCK], zc[FLINT_SIMD_BLOCK]; \
+    ptrdiff_t i, j, m; \
+    for (i=0; i<n; i+=m) { \
+        m = (n-i < FLINT_SIMD_BLOCK) ? (n-i) : FLINT_SIMD_BLOCK; \
+        flint_simd_load(x, sx, m, xa, xb, xv); \
+        flint_simd_load(y, sy, m, ya, yb, yv); \
+        for (j=0; j<FLINT_SIMD_BLOCK; j++) { \
+            int isnan_j = isunordered(xa[j], xb[j]) | isunordered(xv[j], ya[j]) | \
+                          isunordered(yb[j], yv[j]); \
+            nan[j] = (unsigned char) isnan_j; \
+            xa[j] = isnan_j ? 0.0 : xa[j]; \
+            xb[j] = isnan_j ? 0.0 : xb[j]; \
+            ya[j] = isnan_j ? 0.0 : ya[j]; \
+            yb[j] = isnan_j ? 0.0 : yb[j]; \
+        } \
+        for (j=0; j<FLINT_SIMD_BLOCK; j++) { \
+            int c; \
+            body \
+            zc[j] = (unsigned char) c; \
+        } \
+        flint_simd_store_bool(z, sz, m, zc); \
+        x += m*sx; \
+        y += m*sy; \
+        z += m*sz; \
+    } \
+}
+
+// Define a kernel for the minimum or maximum of two flints. The body sets the result
+// from x and y and the flags xnan[j] and ynan[j] that are set if either input has NaN
+// components. Like for the comparisons, a first pass replaces the flints with NaN
+// components with zeros, so that the plain comparisons in the body never see a NaN.
+#define FLINT_SIMD_EXTREMUM(name, body) \
+FLINT_SIMD_TARGET static void FLINT_SIMD_NAME(name)(const char* x, ptrdiff_t sx, \
+                                                    const char* y, ptrdiff_t sy, \
+                                                    char* z, ptrdiff_t sz, \
+                                                    ptrdiff_t n) { \
+    double xa[FLINT_SIMD_BLOCK], xb[FLINT_SIMD_BLOCK], xv[FLINT_SIMD_BLOCK]; \
+    double ya[FLINT_SIMD_BLOCK], yb[FLINT_SIMD_BLOCK], yv[FLINT_SIMD_BLOCK]; \
+    double za[FLINT_SIMD_BLOCK], zb[FLINT_SIMD_BLOCK], zv[FLINT_SIMD_BLOCK]; \
+    unsigned char xnan[FLINT_SIMD_BLOCK], ynan[FLINT_SIMD_BLOCK]; \
+    ptrdiff_t i, j, m; \
+    for (i=0; i<n; i+=m) { \
+        m = (n-i < FLINT_SIMD_BLOCK) ? (n-i) : FLINT_SIMD_BLOCK; \
+        flint_simd_load(x, sx, m, xa, xb, xv); \
+        flint_simd_load(y, sy, m, ya, yb, yv); \
+        for (j=0; j<FLINT_SIMD_BLOCK; j++) { \
+            int xnan_j = isunordered(xa[j], xb[j]) | isunordered(xv[j], xv[j]); \
+            int ynan_j = isunordered(ya[j], yb[j]) | isunordered(yv[j], yv[j]); \
+            xnan[j] = (unsigned char) xnan_j; \
+            ynan[j] = (unsigned char) ynan_j; \
+            xa[j] = xnan_j ? 0.0 : xa[j]; \
+            xb[j] = xnan_j ? 0.0 : xb[j]; \
+            xv[j] = xnan_j ? 0.0 : xv[j]; \
+            ya[j] = ynan_j ? 0.0 : ya[j]; \
+            yb[j] = ynan_j ? 0.0 : yb[j]; \
+            yv[j] = ynan_j ? 0.0 : yv[j]; \
+        } \
+        for (j=0; j<FLINT_SIMD_BLOCK; j++) { \
+            body \
+        } \
+        flint_simd_store(z, sz, m, za, zb, zv); \
+        x += m*sx; \
+        y += m*sy; \
+        z += m*sz; \
+    } \
+}
+
+// The number of lanes used to find the extreme value in a block
+#define FLINT_SIMD_LANES 8
+
+// Define a kernel that finds the index of the first flint with the best value of one
+// of the bounds, or of the first flint with NaN components if there are any. Each block
+// is checked for NaNs and reduced to its best value in separate fixed length loops,
+// the reduction keeping one running value per lane, and only blocks that improve on the
+// best value so far are searched for the index.
+#define FLINT_SIMD_ARG(name, key, cmp) \
+FLINT_SIMD_TARGET static ptrdiff_t FLINT_SIMD_NAME(name)(const flint* x, ptrdiff_t n) { \
+    double xa[FLINT_SIMD_BLOCK], xb[FLINT_SIMD_BLOCK], xv[FLINT_SIMD_BLOCK]; \
+    double lane[FLINT_SIMD_LANES]; \
+    double best = 0.0, block_best; \
+    ptrdiff_t i, j, k, m, best_i = 0; \
+    int nan; \
+    for (i=0; i<n; i+=m) { \
+        m = (n-i < FLINT_SIMD_BLOCK) ? (n-i) : FLINT_SIMD_BLOCK; \
+        flint_simd_load((const char*) (x+i), sizeof(flint), m, xa, xb, xv); \
+        nan = 0; \
+        for (j=0; j<FLINT_SIMD_BLOCK; j++) { \
+            nan |= isunordered(xa[j], xb[j]) | isunordered(xv[j], xv[j]); \
+        } \
+        if (nan) { \
+            for (j=0; !flint_isnan(x[i+j]); j++) {} \
+            return i+j; \
+        } \
+        for (j=m; j<FLINT_SIMD_BLOCK; j++) { \
+            key[j] = key[0]; \
+        } \
+        for (k=0; k<FLINT_SIMD_LANES; k++) { \
+            lane[k] = key[k]; \
+        } \
+        for (j=FLINT_SIMD_LANES; j<FLINT_SIMD_BLOCK; j+=FLINT_SIMD_LANES) { \
+            for (k=0; k<FLINT_SIMD_LANES; k++) { \
+                lane[k] = (key[j+k] cmp lane[k]) ? key[j+k] : lane[k]; \
+            } \
+        } \
+        block_best = lane[0]; \
+        for (k=1; k<FLINT_SIMD_LANES; k++) { \
+            block_best = (lane[k] cmp block_best) ? lane[k] : block_best; \
+        } \
+        if (i == 0 || block_best cmp best) { \
+            for (j=0; key[j] != block_best; j++) {} \
+            best = block_best; \
+            best_i = i+j; \
+        } \
+    } \
+    return best_i; \
+}
+
+// Define a kernel that multiplies a row of flints by the flint x, for the matrix
+// products. The row y and the result z are already split into separate arrays of
+// length n, which must be a multiple of FLINT_SIMD_LANES. The caller pads the rows by
+// repeating a real element, so the padding never raises any new floating point
+// exceptions. The body reads x, ya[j], yb[j], yv[j] and updates za[j], zb[j], zv[j].
+#define FLINT_SIMD_ROW(name, body) \
+FLINT_SIMD_TARGET static void FLINT_SIMD_NAME(name)( \
+        flint x, const double* FLINT_SIMD_RESTRICT ya, \
+        const double* FLINT_SIMD_RESTRICT yb, const double* FLINT_SIMD_RESTRICT yv, \
+        double* FLINT_SIMD_RESTRICT za, double* FLINT_SIMD_RESTRICT zb, \
+        double* FLINT_SIMD_RESTRICT zv, ptrdiff_t n) { \
+    ptrdiff_t i, j; \
+    for (i=0; i<n; i+=FLINT_SIMD_LANES) { \
+        for (j=i; j<i+FLINT_SIMD_LANES; j++) { \
+            body \
+        } \
+    } \
+}
+
+#endif // __FLINT_SIMD_H__
+
+// ---- Kernels for one instruction set ----
+
+FLINT_SIMD_UNARY(negative,
+    za[j] = -xb[j];
+    zb[j] = -xa[j];
+    zv[j] = -xv[j];
+)
+
+FLINT_SIMD_UNARY(absolute,
+    int neg = xb[j] < 0.0;
+    int span = xa[j] < 0.0;
+    za[j] = neg ? -xb[j] : (span ? 0.0 : xa[j]);
+    zb[j] = neg ? -xa[j] : (span ? ((-xa[j] > xb[j]) ? -xa[j] : xb[j]) : xb[j]);
+    zv[j] = neg ? -xv[j] : (span ? ((xv[j] > 0.0) ? xv[j] : -xv[j]) : xv[j]);
+)
+
+// The square roots are taken of the absolute values so that no lane can raise the
+// invalid flag, the lanes where that changes the value are not used. The copysign
+// keeps the -0 that sqrt(-0) returns for the tracked value.
+FLINT_SIMD_UNARY(sqrt,
+    int neg = xb[j] < 0.0;
+    int span = xa[j] < 0.0;
+    double sa = flint_nextdown(sqrt(fabs(xa[j])));
+    double sb = flint_nextup(sqrt(fabs(xb[j])));
+    double sv = copysign(sqrt(fabs(xv[j])), xv[j]);
+    za[j] = neg ? NAN : (span ? 0.0 : sa);
+    zb[j] = neg ? NAN : sb;
+    zv[j] = neg ? NAN : (span ? ((xv[j] > 0.0) ? sv : 0.0) : (isless(xv[j], 0.0) ? NAN : sv));
+)
+
+// The rounding functions are monotonic and exact, so the boundaries are rounded the
+// same way as the tracked value without stepping outwards.
+FLINT_SIMD_UNARY(floor,
+    za[j] = floor(xa[j]);
+    zb[j] = floor(xb[j]);
+    zv[j] = floor(xv[j]);
+)
+
+FLINT_SIMD_UNARY(ceil,
+    za[j] = ceil(xa[j]);
+    zb[j] = ceil(xb[j]);
+    zv[j] = ceil(xv[j]);
+)
+
+FLINT_SIMD_UNARY(trunc,
+    za[j] = trunc(xa[j]);
+    zb[j] = trunc(xb[j]);
+    zv[j] = trunc(xv[j]);
+)
+
+FLINT_SIMD_UNARY(rint,
+    za[j] = rint(xa[j]);
+    zb[j] = rint(xb[j]);
+    zv[j] = rint(xv[j]);
+)
+
+FLINT_SIMD_BINARY(add,
+    za[j] = flint_nextdown(xa[j]+ya[j]);
+    zb[j] = flint_nextup(xb[j]+yb[j]);
+    zv[j] = xv[j]+yv[j];
+)
+
+FLINT_SIMD_BINARY(subtract,
+    za[j] = flint_nextdown(xa[j]-yb[j]);
+    zb[j] = flint_nextup(xb[j]-ya[j]);
+    zv[j] = xv[j]-yv[j];
+)
+
+FLINT_SIMD_BINARY(multiply,
+    double aa = xa[j]*ya[j];
+    double ab = xa[j]*yb[j];
+    double ba = xb[j]*ya[j];
+    double bb = xb[j]*yb[j];
+    za[j] = flint_nextdown(min4(aa, ab, ba, bb));
+    zb[j] = flint_nextup(max4(aa, ab, ba, bb));
+    zv[j] = xv[j]*yv[j];
+)
+
+FLINT_SIMD_BINARY(divide,
+    double aa = xa[j]/ya[j];
+    double ab = xa[j]/yb[j];
+    double ba = xb[j]/ya[j];
+    double bb = xb[j]/yb[j];
+    za[j] = flint_nextdown(min4(aa, ab, ba, bb));
+    zb[j] = flint_nextup(max4(aa, ab, ba, bb));
+    zv[j] = xv[j]/yv[j];
+)
+
+FLINT_SIMD_EXTREMUM(minimum,
+    int nan = xnan[j] | ynan[j];
+    za[j] = nan ? NAN : ((xa[j] < ya[j]) ? xa[j] : ya[j]);
+    zb[j] = nan ? NAN : ((xb[j] < yb[j]) ? xb[j] : yb[j]);
+    zv[j] = nan ? NAN : ((xv[j] < yv[j]) ? xv[j] : yv[j]);
+)
+
+FLINT_SIMD_EXTREMUM(maximum,
+    int nan = xnan[j] | ynan[j];
+    za[j] = nan ? NAN : ((xa[j] > ya[j]) ? xa[j] : ya[j]);
+    zb[j] = nan ? NAN : ((xb[j] > yb[j]) ? xb[j] : yb[j]);
+    zv[j] = nan ? NAN : ((xv[j] > yv[j]) ? xv[j] : yv[j]);
+)
+
+// Where only one input is NaN the other one was left in place by the first pass
+FLINT_SIMD_EXTREMUM(fmin,
+    int nan = xnan[j] & ynan[j];
+    za[j] = nan ? NAN : (xnan[j] ? ya[j] : (ynan[j] ? xa[j] : ((xa[j] < ya[j]) ? xa[j] : ya[j])));
+    zb[j] = nan ? NAN : (xnan[j] ? yb[j] : (ynan[j] ? xb[j] : ((xb[j] < yb[j]) ? xb[j] : yb[j])));
+    zv[j] = nan ? NAN : (xnan[j] ? yv[j] : (ynan[j] ? xv[j] : ((xv[j] < yv[j]) ? xv[j] : yv[j])));
+)
+
+FLINT_SIMD_EXTREMUM(fmax,
+    int nan = xnan[j] & ynan[j];
+    za[j] = nan ? NAN : (xnan[j] ? ya[j] : (ynan[j] ? xa[j] : ((xa[j] > ya[j]) ? xa[j] : ya[j])));
+    zb[j] = nan ? NAN : (xnan[j] ? yb[j] : (ynan[j] ? xb[j] : ((xb[j] > yb[j]) ? xb[j] : yb[j])));
+    zv[j] = nan ? NAN : (xnan[j] ? yv[j] : (ynan[j] ? xv[j] : ((xv[j] > yv[j]) ? xv[j] : yv[j])));
+)
+
+// The fused multiply-add rounds each boundary once, like flint_fma
+FLINT_SIMD_TERNARY(madd,
+    za[j] = flint_nextdown(min4(fma(xa[j], ya[j], wa[j]), fma(xa[j], yb[j], wa[j]),
+                                fma(xb[j], ya[j], wa[j]), fma(xb[j], yb[j], wa[j])));
+    zb[j] = flint_nextup(max4(fma(xa[j], ya[j], wb[j]), fma(xa[j], yb[j], wb[j]),
+                              fma(xb[j], ya[j], wb[j]), fma(xb[j], yb[j], wb[j])));
+    zv[j] = fma(xv[j], yv[j], wv[j]);
+)
+
+// The product z = x*y, and the fused multiply-add z = x*y + z
+FLINT_SIMD_ROW(mul_row,
+    double aa = x.a*ya[j];
+    double ab = x.a*yb[j];
+    double ba = x.b*ya[j];
+    double bb = x.b*yb[j];
+    za[j] = flint_nextdown(min4(aa, ab, ba, bb));
+    zb[j] = flint_nextup(max4(aa, ab, ba, bb));
+    zv[j] = x.v*yv[j];
+)
+// The row multiply-add is only fused with a hardware fma, like flint_inplace_madd
+#ifndef FLINT_SIMD_FMA
+#define FLINT_SIMD_FMA FLINT_FAST_FMA
+#endif
+#if FLINT_SIMD_FMA
+FLINT_SIMD_ROW(madd_row,
+    double za_j = za[j];
+    double zb_j = zb[j];
+    za[j] = flint_nextdown(min4(fma(x.a, ya[j], za_j), fma(x.a, yb[j], za_j),
+                                fma(x.b, ya[j], za_j), fma(x.b, yb[j], za_j)));
+    zb[j] = flint_nextup(max4(fma(x.a, ya[j], zb_j), fma(x.a, yb[j], zb_j),
+                              fma(x.b, ya[j], zb_j), fma(x.b, yb[j], zb_j)));
+    zv[j] = fma(x.v, yv[j], zv[j]);
+)
+#else
+FLINT_SIMD_ROW(madd_row,
+    double aa = x.a*ya[j];
+    double ab = x.a*yb[j];
+    double ba = x.b*ya[j];
+    double bb = x.b*yb[j];
+    za[j] = flint_nextdown(za[j] + flint_nextdown(min4(aa, ab, ba, bb)));
+    zb[j] = flint_nextup(zb[j] + flint_nextup(max4(aa, ab, ba, bb)));
+    zv[j] = zv[j] + x.v*yv[j];
+)
+#endif
+
+// The smallest lower bound and the largest upper bound
+FLINT_SIMD_ARG(argmin, xa, <)
+FLINT_SIMD_ARG(argmax, xb, >)
+
+FLINT_SIMD_COMPARE(eq,
+    c = (nan[j] == 0) & islessequal(xa[j], yb[j]) & isgreaterequal(xb[j], ya[j]);
+)
+FLINT_SIMD_COMPARE(ne,
+    c = nan[j] | isgreater(xa[j], yb[j]) | isless(xb[j], ya[j]);
+)
+FLINT_SIMD_COMPARE(le, c = (nan[j] == 0) & islessequal(xa[j], yb[j]);)
+FLINT_SIMD_COMPARE(lt, c = (nan[j] == 0) & isless(xb[j], ya[j]);)
+FLINT_SIMD_COMPARE(ge, c = (nan[j] == 0) & isgreaterequal(xb[j], ya[j]);)
+FLINT_SIMD_COMPARE(gt, c = (nan[j] == 0) & isgreater(xa[j], yb[j]);)
+
+static const flint_simd_kernels FLINT_SIMD_NAME(kernels) = {
+    FLINT_SIMD_ISA,
+    FLINT_SIMD_NAME(add),
+    FLINT_SIMD_NAME(subtract),
+    FLINT_SIMD_NAME(multiply),
+    FLINT_SIMD_NAME(divide),
+    FLINT_SIMD_NAME(madd),
+    FLINT_SIMD_NAME(minimum),
+    FLINT_SIMD_NAME(maximum),
+    FLINT_SIMD_NAME(fmin),
+    FLINT_SIMD_NAME(fmax),
+    FLINT_SIMD_NAME(eq),
+    FLINT_SIMD_NAME(ne),
+    FLINT_SIMD_NAME(lt),
+    FLINT_SIMD_NAME(le),
+    FLINT_SIMD_NAME(gt),
+    FLINT_SIMD_NAME(ge),
+    FLINT_SIMD_NAME(negative),
+    FLINT_SIMD_NAME(absolute),
+    FLINT_SIMD_NAME(sqrt),
+    FLINT_SIMD_NAME(floor),
+    FLINT_SIMD_NAME(ceil),
+    FLINT_SIMD_NAME(trunc),
+    FLINT_SIMD_NAME(rint),
+    FLINT_SIMD_NAME(argmin),
+    FLINT_SIMD_NAME(argmax),
+    FLINT_SIMD_NAME(mul_row),
+    FLINT_SIMD_NAME(madd_row),
+};
+
+#undef FLINT_SIMD_NAME
+#undef FLINT_SIMD_TARGET
+#undef FLINT_SIMD_ISA
+#undef FLINT_SIMD_FMA
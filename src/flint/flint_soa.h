@@ -0,0 +1,385 @@
+/**
+ * Structure of arrays container for flints
+ */
+// Copyright (c) 2023, Jef Wagner <jefwagner@gmail.com>
+//
+// This file is part of numpy-flint.
+//
+// Numpy-flint is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// Numpy-flint is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// numpy-flint. If not, see <https://www.gnu.org/licenses/>.
+//
+#ifndef __FLINT_SOA_H__
+#define __FLINT_SOA_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "flint.h"
+
+/**
+ * .. _flint_soa:
+ *
+ * Structure of arrays
+ * -------------------
+ *
+ * An array of :c:type:`flint` structs interleaves the lower bounds, upper bounds, and
+ * tracked values. The ``flint_soa`` container instead keeps them in three separate
+ * arrays, each aligned to a 64 byte boundary. Loops over the separate arrays are easy
+ * for the compiler to vectorize, and functions that only need the boundaries, like
+ * :c:func:`flint_soa_isinf` or the comparisons, only read two thirds of the memory.
+ *
+ * The batch functions below cover the same operations as the functions for single
+ * flints and give the same results. All the arrays passed to a batch function must
+ * have the same length. The output can be the same container as one of the inputs.
+ */
+
+/**
+ * The alignment in bytes of the arrays in a :c:type:`flint_soa`
+ */
+#define FLINT_SOA_ALIGN 64
+
+/**
+ * A structure of arrays holding ``n`` flints
+ */
+typedef struct {
+    /**
+     * The lower bounds
+     */
+    double* a;
+    /**
+     * The upper bounds
+     */
+    double* b;
+    /**
+     * The tracked values
+     */
+    double* v;
+    /**
+     * The number of flints
+     */
+    size_t n;
+    /**
+     * The allocated memory that holds all three arrays
+     */
+    void* mem;
+} flint_soa;
+
+/**
+ * .. _flint_soa_init:
+ *
+ * Allocate the arrays for ``n`` flints. All three arrays are carved out of a single
+ * allocation. Returns 0 on success and -1 if the memory could not be allocated.
+ */
+static inline int flint_soa_init(flint_soa* s, size_t n) {
+    // Pad each array to a whole number of aligned blocks
+    size_t per_block = FLINT_SOA_ALIGN/sizeof(double);
+    size_t m = (n + per_block - 1)/per_block*per_block;
+    uintptr_t p;
+    s->mem = malloc(3*m*sizeof(double) + FLINT_SOA_ALIGN);
+    if (s->mem == NULL) {
+        s->a = NULL; s->b = NULL; s->v = NULL; s->n = 0;
+        return -1;
+    }
+    p = ((uintptr_t) s->mem + FLINT_SOA_ALIGN - 1)/FLINT_SOA_ALIGN*FLINT_SOA_ALIGN;
+    s->a = (double*) p;
+    s->b = s->a + m;
+    s->v = s->b + m;
+    s->n = n;
+    return 0;
+}
+
+/**
+ * .. _flint_soa_free:
+ */
+static inline void flint_soa_free(flint_soa* s) {
+    free(s->mem);
+    s->mem = NULL;
+    s->a = NULL; s->b = NULL; s->v = NULL; s->n = 0;
+}
+
+/**
+ * .. _flint_soa_get:
+ */
+static inline flint flint_soa_get(const flint_soa* s, size_t i) {
+    flint f = {s->a[i], s->b[i], s->v[i]};
+    return f;
+}
+
+/**
+ * .. _flint_soa_set:
+ */
+static inline void flint_soa_set(flint_soa* s, size_t i, flint f) {
+    s->a[i] = f.a;
+    s->b[i] = f.b;
+    s->v[i] = f.v;
+}
+
+/**
+ * .. _flint_soa_from_flint:
+ *
+ * Fill the container from ``s->n`` flints, which are ``stride`` bytes apart. Use
+ * ``sizeof(flint)`` for a contiguous array.
+ */
+static inline void flint_soa_from_flint(flint_soa* s, const flint* f, ptrdiff_t stride) {
+    const char* p = (const char*) f;
+    size_t i;
+    for (i=0; i<s->n; i++) {
+        s->a[i] = ((const flint*) p)->a;
+        s->b[i] = ((const flint*) p)->b;
+        s->v[i] = ((const flint*) p)->v;
+        p += stride;
+    }
+}
+
+/**
+ * .. _flint_soa_to_flint:
+ *
+ * Write the ``s->n`` flints in the container to flints that are ``stride`` bytes apart.
+ */
+static inline void flint_soa_to_flint(const flint_soa* s, flint* f, ptrdiff_t stride) {
+    char* p = (char*) f;
+    size_t i;
+    for (i=0; i<s->n; i++) {
+        ((flint*) p)->a = s->a[i];
+        ((flint*) p)->b = s->b[i];
+        ((flint*) p)->v = s->v[i];
+        p += stride;
+    }
+}
+
+/**
+ * Special value queries and comparisons
+ * """""""""""""""""""""""""""""""""""""
+ *
+ * The results are written to an array of ``s->n`` bytes that are 1 for true and 0 for
+ * false. Only ``isnan`` and the comparisons, which treat a NaN tracked value as NaN,
+ * read the tracked values.
+ */
+
+/**
+ * .. _flint_soa_nonzero:
+ */
+static inline void flint_soa_nonzero(const flint_soa* s, unsigned char* out) {
+    size_t i;
+    for (i=0; i<s->n; i++) {
+        out[i] = (s->a[i] > 0.0) | (s->b[i] < 0.0);
+    }
+}
+
+/**
+ * .. _flint_soa_isnan:
+ */
+static inline void flint_soa_isnan(const flint_soa* s, unsigned char* out) {
+    size_t i;
+    for (i=0; i<s->n; i++) {
+        out[i] = isunordered(s->a[i], s->b[i]) | isunordered(s->v[i], s->v[i]);
+    }
+}
+
+/**
+ * .. _flint_soa_isinf:
+ */
+static inline void flint_soa_isinf(const flint_soa* s, unsigned char* out) {
+    size_t i;
+    for (i=0; i<s->n; i++) {
+        out[i] = (fabs(s->a[i]) == INFINITY) | (fabs(s->b[i]) == INFINITY);
+    }
+}
+
+/**
+ * .. _flint_soa_isfinite:
+ */
+static inline void flint_soa_isfinite(const flint_soa* s, unsigned char* out) {
+    size_t i;
+    for (i=0; i<s->n; i++) {
+        out[i] = isless(fabs(s->a[i]), INFINITY) & isless(fabs(s->b[i]), INFINITY);
+    }
+}
+
+#define FLINT_SOA_COMPARE(name) \
+static inline void flint_soa_##name(const flint_soa* s1, const flint_soa* s2, \
+                                    unsigned char* out) { \
+    size_t i; \
+    for (i=0; i<s1->n; i++) { \
+        out[i] = flint_##name(flint_soa_get(s1, i), flint_soa_get(s2, i)); \
+    } \
+}
+FLINT_SOA_COMPARE(eq)
+FLINT_SOA_COMPARE(ne)
+FLINT_SOA_COMPARE(le)
+FLINT_SOA_COMPARE(lt)
+FLINT_SOA_COMPARE(ge)
+FLINT_SOA_COMPARE(gt)
+
+/**
+ * Arithmetic
+ * """"""""""
+ *
+ * The arithmetic is written directly on the arrays. With the default rounding the
+ * outward rounding uses :c:func:`flint_nextup` and :c:func:`flint_nextdown`, which the
+ * compiler can vectorize, instead of ``nextafter``. With directed rounding the
+ * rounding mode is switched once for the whole array instead of once per element.
+ */
+
+/**
+ * .. _flint_soa_negative:
+ */
+static inline void flint_soa_negative(const flint_soa* s, flint_soa* out) {
+    double a;
+    size_t i;
+    for (i=0; i<s->n; i++) {
+        a = s->a[i];
+        out->a[i] = -s->b[i];
+        out->b[i] = -a;
+        out->v[i] = -s->v[i];
+    }
+}
+
+#ifdef FLINT_DIRECTED_ROUNDING
+#define FLINT_SOA_ARITHMETIC(name, op) \
+static inline void flint_soa_##name(const flint_soa* s1, const flint_soa* s2, \
+                                    flint_soa* out) { \
+    flint f; \
+    size_t i; \
+    int mode = flint_round_upward(); \
+    for (i=0; i<s1->n; i++) { \
+        flint_##name##_ru(flint_soa_get(s1, i), flint_soa_get(s2, i), &f); \
+        out->a[i] = f.a; \
+        out->b[i] = f.b; \
+    } \
+    flint_round_restore(mode); \
+    for (i=0; i<s1->n; i++) { \
+        out->v[i] = s1->v[i] op s2->v[i]; \
+    } \
+}
+#else
+#define FLINT_SOA_ARITHMETIC(name, op) \
+static inline void flint_soa_##name(const flint_soa* s1, const flint_soa* s2, \
+                                    flint_soa* out) { \
+    double aa, ab, ba, bb; \
+    size_t i; \
+    for (i=0; i<s1->n; i++) { \
+        aa = s1->a[i] op s2->a[i]; \
+        ab = s1->a[i] op s2->b[i]; \
+        ba = s1->b[i] op s2->a[i]; \
+        bb = s1->b[i] op s2->b[i]; \
+        out->v[i] = s1->v[i] op s2->v[i]; \
+        out->a[i] = flint_nextdown(min4(aa, ab, ba, bb)); \
+        out->b[i] = flint_nextup(max4(aa, ab, ba, bb)); \
+    } \
+}
+#endif
+
+/**
+ * .. _flint_soa_add:
+ *
+ * .. _flint_soa_subtract:
+ *
+ * .. _flint_soa_multiply:
+ *
+ * .. _flint_soa_divide:
+ */
+#ifdef FLINT_DIRECTED_ROUNDING
+FLINT_SOA_ARITHMETIC(add, +)
+FLINT_SOA_ARITHMETIC(subtract, -)
+#else
+// Addition and subtraction only need two of the four combinations of the boundaries
+static inline void flint_soa_add(const flint_soa* s1, const flint_soa* s2,
+                                 flint_soa* out) {
+    size_t i;
+    for (i=0; i<s1->n; i++) {
+        out->a[i] = flint_nextdown(s1->a[i] + s2->a[i]);
+        out->b[i] = flint_nextup(s1->b[i] + s2->b[i]);
+        out->v[i] = s1->v[i] + s2->v[i];
+    }
+}
+
+static inline void flint_soa_subtract(const flint_soa* s1, const flint_soa* s2,
+                                      flint_soa* out) {
+    double a;
+    size_t i;
+    for (i=0; i<s1->n; i++) {
+        a = flint_nextdown(s1->a[i] - s2->b[i]);
+        out->b[i] = flint_nextup(s1->b[i] - s2->a[i]);
+        out->a[i] = a;
+        out->v[i] = s1->v[i] - s2->v[i];
+    }
+}
+#endif
+FLINT_SOA_ARITHMETIC(multiply, *)
+FLINT_SOA_ARITHMETIC(divide, /)
+
+/**
+ * Math functions
+ * """"""""""""""
+ *
+ * The math functions apply the functions for single flints to each element.
+ *
+ * .. c:function:: static inline void flint_soa_FUNCNAME(const flint_soa* s, flint_soa* out)
+ *
+ * .. c:function:: static inline void flint_soa_FUNCNAME(const flint_soa* s1, const flint_soa* s2, flint_soa* out)
+ *
+ *     for the binary functions ``power``, ``hypot``, and ``atan2``
+ */
+#define FLINT_SOA_UNARY(name) \
+static inline void flint_soa_##name(const flint_soa* s, flint_soa* out) { \
+    size_t i; \
+    for (i=0; i<s->n; i++) { \
+        flint_soa_set(out, i, flint_##name(flint_soa_get(s, i))); \
+    } \
+}
+#define FLINT_SOA_BINARY(name) \
+static inline void flint_soa_##name(const flint_soa* s1, const flint_soa* s2, \
+                                    flint_soa* out) { \
+    size_t i; \
+    for (i=0; i<s1->n; i++) { \
+        flint_soa_set(out, i, flint_##name(flint_soa_get(s1, i), flint_soa_get(s2, i))); \
+    } \
+}
+FLINT_SOA_UNARY(absolute)
+FLINT_SOA_UNARY(sqrt)
+FLINT_SOA_UNARY(cbrt)
+FLINT_SOA_UNARY(exp)
+FLINT_SOA_UNARY(exp2)
+FLINT_SOA_UNARY(expm1)
+FLINT_SOA_UNARY(log)
+FLINT_SOA_UNARY(log10)
+FLINT_SOA_UNARY(log2)
+FLINT_SOA_UNARY(log1p)
+FLINT_SOA_UNARY(erf)
+FLINT_SOA_UNARY(erfc)
+FLINT_SOA_UNARY(sin)
+FLINT_SOA_UNARY(cos)
+FLINT_SOA_UNARY(tan)
+FLINT_SOA_UNARY(asin)
+FLINT_SOA_UNARY(acos)
+FLINT_SOA_UNARY(atan)
+FLINT_SOA_UNARY(sinh)
+FLINT_SOA_UNARY(cosh)
+FLINT_SOA_UNARY(tanh)
+FLINT_SOA_UNARY(asinh)
+FLINT_SOA_UNARY(acosh)
+FLINT_SOA_UNARY(atanh)
+FLINT_SOA_BINARY(power)
+FLINT_SOA_BINARY(hypot)
+FLINT_SOA_BINARY(atan2)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FLINT_SOA_H__
@@ -17,7 +17,9 @@
 // You should have received a copy of the GNU General Public License along with
 // numpy-flint. If not, see <https://www.gnu.org/licenses/>.
 //
+#include <fenv.h>
 #include <stdint.h>
+#include <time.h>
 #include <Python.h>
 
 #define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
@@ -91,59 +93,115 @@ static PyObject* pyflint_##name##_meth(PyObject* self, \
     return pyflint_##name(self); \
 }
 
+/// @brief Convert a python or numpy number into a flint, the same way as the constructor
+/// Integers are exact if they fit in a double, everything else is turned into a double
+/// and widened by an ulp. Strings, arrays, and other objects that are not numbers are
+/// refused.
+/// @param O The python object
+/// @param fp A pointer to the flint to fill
+/// @return 1 on success, 0 if O is not a number (with no error set), -1 on an error
+static int pyflint_number_to_flint(PyObject* O, flint* fp) {
+    PyObject* N = NULL;
+    long long n = 0;
+    int overflow = 0;
+    double d = 0.0;
+    if (PyFloat_Check(O)) {
+        *fp = double_to_flint(PyFloat_AS_DOUBLE(O));
+        return 1;
+    }
+    if (PyLong_Check(O) || PyArray_IsScalar(O, Integer) || PyArray_IsScalar(O, Bool)) {
+        if (PyLong_Check(O)) {
+            Py_INCREF(O);
+            N = O;
+        } else {
+            N = PyNumber_Long(O);
+            if (N == NULL) {
+                return -1;
+            }
+        }
+        n = PyLong_AsLongLongAndOverflow(N, &overflow);
+        if (overflow) { // integers too large for a long long go through a double
+            d = PyLong_AsDouble(N);
+            Py_DECREF(N);
+            if (d == -1.0 && PyErr_Occurred()) {
+                return -1;
+            }
+            *fp = double_to_flint(d);
+            return 1;
+        }
+        Py_DECREF(N);
+        if (n == -1 && PyErr_Occurred()) {
+            return -1;
+        }
+        *fp = int_to_flint(n);
+        return 1;
+    }
+    // Arrays are refused so the binary operators hand them over to numpy
+    if (PyArray_Check(O) || !PyNumber_Check(O)) {
+        return 0;
+    }
+    d = PyFloat_AsDouble(O);
+    if (d == -1.0 && PyErr_Occurred()) {
+        return -1;
+    }
+    *fp = double_to_flint(d);
+    return 1;
+}
+
 /// @brief A macro that defines functions of two variables that return a flint
 /// @param name the name of the function in the c and pyflint implementation
 /// @return The result of c function flint_{name} or Py_NotImplemented
+/// Floats go to the flint_{name}_scalar kernels, other numbers are converted exactly
+/// like the constructor, and errors from the conversion are passed on.
 #define BINARY_FLINT_RETURNER(name) \
 static PyObject* pyflint_##name(PyObject* a, PyObject* b) { \
-    flint fa = {0.0, 0.0, 0.0}; \
-    flint fb = {0.0, 0.0, 0.0}; \
-    double d = 0.0; \
-    PyObject* D = {0}; \
+    flint f = {0.0, 0.0, 0.0}; \
+    int ret = 0; \
     if (PyFlint_Check(a)) { \
-        fa = ((PyFlint*)a)->obval;\
-        if (PyFlint_Check(b)) {\
-            fb = ((PyFlint*)b)->obval;\
-            return PyFlint_FromFlint(flint_##name(fa,fb)); \
-        } else { \
-            D = PyNumber_Float(b); \
-            if (D) { \
-                d = PyFloat_AsDouble(D); \
-                fb = double_to_flint(d); \
-                return PyFlint_FromFlint(flint_##name(fa, fb)); \
-            } \
+        if (PyFlint_Check(b)) { \
+            return PyFlint_FromFlint(flint_##name(((PyFlint*) a)->obval, \
+                                                  ((PyFlint*) b)->obval)); \
+        } else if (PyFloat_Check(b)) { \
+            return PyFlint_FromFlint(flint_##name##_scalar(((PyFlint*) a)->obval, \
+                                                           PyFloat_AS_DOUBLE(b))); \
         } \
-    } else { \
-        D = PyNumber_Float(a); \
-        if (D) { \
-            fb = ((PyFlint*)b)->obval; \
-            d = PyFloat_AsDouble(D); \
-            fa = double_to_flint(d); \
-            return PyFlint_FromFlint(flint_##name(fa, fb)); \
+        ret = pyflint_number_to_flint(b, &f); \
+        if (ret == 1) { \
+            return PyFlint_FromFlint(flint_##name(((PyFlint*) a)->obval, f)); \
+        } \
+    } else if (PyFlint_Check(b)) { \
+        if (PyFloat_Check(a)) { \
+            return PyFlint_FromFlint(flint_scalar_##name(PyFloat_AS_DOUBLE(a), \
+                                                         ((PyFlint*) b)->obval)); \
+        } \
+        ret = pyflint_number_to_flint(a, &f); \
+        if (ret == 1) { \
+            return PyFlint_FromFlint(flint_##name(f, ((PyFlint*) b)->obval)); \
         } \
     } \
-    PyErr_SetString(PyExc_TypeError, \
-        "Binary operations for functions with PyFlint must be with numeric type"); \
-    Py_INCREF(Py_NotImplemented); \
-    return Py_NotImplemented; \
+    if (ret < 0) { \
+        return NULL; \
+    } \
+    Py_RETURN_NOTIMPLEMENTED; \
 }
 
 /// @brief A macro that makes a operator or function a method acting on self
 /// @param name The name of the function in the c and pyflint implementation
 /// @return The result of the Python/C pyflint_{name} function
 #define BINARY_TO_SELF_METHOD(name) \
-static PyObject* pyflint_##name##_meth(PyObject* self, PyObject* args) { \
-    Py_ssize_t size = PyTuple_Size(args); \
-    PyObject* O = {0}; \
-    if (size == 1) { \
-        if (PyArg_ParseTuple(args, "O", &O)) { \
-            return pyflint_##name(self, O); \
+static PyObject* pyflint_##name##_meth(PyObject* self, PyObject* const* args, \
+                                       Py_ssize_t nargs) { \
+    PyObject* ret = NULL; \
+    if (nargs == 1) { \
+        ret = pyflint_##name(self, args[0]); \
+        if (ret != Py_NotImplemented) { \
+            return ret; \
         } \
+        Py_DECREF(ret); \
     } \
     PyErr_SetString(PyExc_TypeError, \
         "Binary operations for functions with PyFlint must be with numeric type"); \
-    Py_INCREF(Py_NotImplemented); \
-    return Py_NotImplemented; \
+    return NULL; \
 }
 
 /// @brief A macro that defines an inplace operator
@@ -151,32 +209,29 @@ static PyObject* pyflint_##name##_meth(PyObject* self, PyObject* args) { \
 /// @return The `a` PyFlint object c func flint_inplace_{name} acting on `obval`
 #define BINARY_FLINT_INPLACE(name) \
 static PyObject* pyflint_inplace_##name(PyObject* a, PyObject* b) { \
-    flint* fptr = NULL; \
-    flint fb = {0.0, 0.0, 0.0}; \
-    double d = 0.0; \
-    PyObject* D = {0}; \
+    flint f = {0.0, 0.0, 0.0}; \
+    int ret = 0; \
     if (PyFlint_Check(a)) { \
-        fptr = &(((PyFlint*) a)->obval); \
         if (PyFlint_Check(b)) { \
-            fb = ((PyFlint*) b)->obval; \
-            flint_inplace_##name(fptr, fb); \
+            flint_inplace_##name(&(((PyFlint*) a)->obval), ((PyFlint*) b)->obval); \
+            Py_INCREF(a); \
+            return a; \
+        } else if (PyFloat_Check(b)) { \
+            flint_inplace_##name##_scalar(&(((PyFlint*) a)->obval), PyFloat_AS_DOUBLE(b)); \
+            Py_INCREF(a); \
+            return a; \
+        } \
+        ret = pyflint_number_to_flint(b, &f); \
+        if (ret == 1) { \
+            flint_inplace_##name(&(((PyFlint*) a)->obval), f); \
             Py_INCREF(a); \
             return a; \
-        } else { \
-            D = PyNumber_Float(b); \
-            if (D) { \
-                d = PyFloat_AsDouble(D); \
-                fb = double_to_flint(d); \
-                flint_inplace_##name(fptr, fb); \
-                Py_INCREF(a); \
-                return a; \
-            } \
         } \
     } \
-    PyErr_SetString(PyExc_TypeError, \
-        "+=,-=,*=,/= inplace operations with PyFlint must be with numeric type"); \
-    Py_INCREF(Py_NotImplemented); \
-    return Py_NotImplemented; \
+    if (ret < 0) { \
+        return NULL; \
+    } \
+    Py_RETURN_NOTIMPLEMENTED; \
 }
 
 /// @brief A macro that wraps a binary function into a tertiary function
@@ -205,60 +260,160 @@ static inline PyObject* pyflint_b2t_inplace_##name(PyObject *a, PyObject* b, \
 // --------------------------------
 // ---- Object handler methods ----
 // --------------------------------
+/// @brief The most deallocated PyFlint objects kept around for reuse
+#define NPYFLINT_MAX_FREE_LIST 100
+/// @brief Deallocated PyFlint objects that can be reused without an allocation
+static PyFlint* npyflint_free_list[NPYFLINT_MAX_FREE_LIST];
+/// @brief The number of objects in the free list
+static int npyflint_num_free = 0;
+
+/// @brief Create a new PyFlint, reusing an object from the free list if possible
+/// @param f The c flint struct
+/// @return A new PyFlint object that contains a copy of f
+static PyObject* pyflint_from_flint(flint f) {
+    PyFlint* p;
+    if (npyflint_num_free > 0) {
+        p = npyflint_free_list[--npyflint_num_free];
+        PyObject_Init((PyObject*) p, &PyFlint_Type);
+    } else {
+        p = (PyFlint*) PyFlint_Type.tp_alloc(&PyFlint_Type, 0);
+        if (p == NULL) {
+            return NULL;
+        }
+    }
+    p->obval = f;
+    return (PyObject*) p;
+}
+
+/// @brief The destructor, which puts flints (but not subclasses) on the free list
+/// @param self The object to be destroyed
+static void pyflint_dealloc(PyObject* self) {
+    if (Py_TYPE(self) == &PyFlint_Type && npyflint_num_free < NPYFLINT_MAX_FREE_LIST) {
+        npyflint_free_list[npyflint_num_free++] = (PyFlint*) self;
+    } else {
+        Py_TYPE(self)->tp_free(self);
+    }
+}
+
 /// @brief The __new__ allocating constructor
 /// @param type The type of the PyObject
 /// @return A new PyObject of type `type`
 static PyObject* pyflint_new(PyTypeObject* type, 
                              PyObject* NPY_UNUSED(args),
                              PyObject* NPY_UNUSED(kwargs)) {
-    PyFlint* self = (PyFlint*) type->tp_alloc(type, 0);
-    return (PyObject*) self;
+    flint zero = {0.0, 0.0, 0.0};
+    if (type == &PyFlint_Type) {
+        return pyflint_from_flint(zero);
+    }
+    return type->tp_alloc(type, 0);
+}
+
+/// @brief Convert the single argument of the constructor into a flint
+/// @param O A PyObject with either a flint, or a python or numpy number
+/// @param fp A pointer to the flint to fill
+/// @return 0 on success, -1 on failure
+static int pyflint_init_from_object(PyObject* O, flint* fp) {
+    int ret = 0;
+    // One argument of a PyFlint (copy constructor)
+    if (PyFlint_Check(O)) {
+        *fp = ((PyFlint*) O)->obval;
+        return 0;
+    }
+    // One argument of a numeric type (standard constructor)
+    ret = pyflint_number_to_flint(O, fp);
+    if (ret == 0) {
+        PyErr_SetString(PyExc_TypeError,
+                        "flint constructor one numeric argument");
+    }
+    return (ret == 1) ? 0 : -1;
+}
+
+/// @brief Set a flint from the three numbers a, b, and v
+/// @param args An array of 3 PyObjects with the lower bound, upper bound, and tracked
+///             value that can be converted to doubles
+/// @param fp A pointer to the flint to fill
+/// @return 0 on success, -1 on failure
+/// The components must satisfy a <= v <= b unless one of them is NaN, so that the
+/// constructor can not make an interval that does not contain its tracked value.
+static int pyflint_init_from_components(PyObject* const* args, flint* fp) {
+    double d[3];
+    int i;
+    for (i=0; i<3; i++) {
+        d[i] = PyFloat_AsDouble(args[i]);
+        if (d[i] == -1.0 && PyErr_Occurred()) {
+            return -1;
+        }
+    }
+    if (!(d[0] <= d[2] && d[2] <= d[1]) &&
+        !isnan(d[0]) && !isnan(d[1]) && !isnan(d[2])) {
+        PyErr_SetString(PyExc_ValueError,
+                        "flint components must satisfy a <= v <= b");
+        return -1;
+    }
+    fp->a = d[0];
+    fp->b = d[1];
+    fp->v = d[2];
+    return 0;
 }
 
 /// @brief The __init__ initializing constructor
 /// @param self The object to be initialized
-/// @param args A tuple containing 1 PyObject with either a flint, float, or int
+/// @param args A tuple containing 1 PyObject with either a flint, float, or int, or
+///             the 3 components a, b, and v
 /// @param kwargs An empty tuple
 /// @return 0 on success, -1 on failure
 static int pyflint_init(PyObject* self, PyObject* args, PyObject* kwargs) {
-    Py_ssize_t size = PyTuple_Size(args);
-    PyObject* O = {0};
-    flint* fp = &(((PyFlint*) self)->obval);
-    double d;
-    long long n;
-
     if (kwargs && PyDict_Size(kwargs)) {
         PyErr_SetString(PyExc_TypeError,
                         "flint constructor doesn't take keyword arguments");
         return -1;
     }
+    if (PyTuple_GET_SIZE(args) == 3) {
+        return pyflint_init_from_components(PySequence_Fast_ITEMS(args),
+                                            &(((PyFlint*) self)->obval));
+    }
+    if (PyTuple_GET_SIZE(args) != 1) {
+        PyErr_SetString(PyExc_TypeError,
+                        "flint constructor one numeric argument");
+        return -1;
+    }
+    return pyflint_init_from_object(PyTuple_GET_ITEM(args, 0),
+                                    &(((PyFlint*) self)->obval));
+}
 
-    if (size == 1) {
-        if (PyArg_ParseTuple(args, "O", &O)) {
-            // One argument of an integer type (standard constructor) 
-            if (PyLong_Check(O)) {
-                n = PyLong_AsLongLong(O);
-                *fp = int_to_flint(n);
-                return 0;
-            }
-            // One argument of a floating type (standard constructor)
-            else if (PyFloat_Check(O)) {
-                d = PyFloat_AsDouble(O);
-                *fp = double_to_flint(d);
-                return 0;
-            }
-            // One argument of a PyFlint (copy constructor)
-            else if (PyFlint_Check(O)) {
-                *fp = ((PyFlint*) O)->obval;
-                return 0;
-            }
+#if PY_VERSION_HEX >= 0x03090000
+/// @brief The vectorcall constructor, used for `flint(x)` in place of __new__ and __init__
+/// @param type The flint type object (the slot is not inherited by subclasses)
+/// @param args An array with 1 PyObject with either a flint, float, or int, or the 3
+///             components a, b, and v
+/// @param nargsf The number of arguments, possibly with the offset flag set
+/// @param kwnames The names of the keyword arguments, should be NULL or empty
+/// @return A new PyFlint object on success, NULL on failure
+static PyObject* pyflint_vectorcall(PyObject* NPY_UNUSED(type), PyObject* const* args,
+                                    size_t nargsf, PyObject* kwnames) {
+    flint f = {0.0, 0.0, 0.0};
+    if (kwnames && PyTuple_GET_SIZE(kwnames)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "flint constructor doesn't take keyword arguments");
+        return NULL;
+    }
+    if (PyVectorcall_NARGS(nargsf) == 3) {
+        if (pyflint_init_from_components(args, &f) < 0) {
+            return NULL;
         }
+        return pyflint_from_flint(f);
     }
-
-    PyErr_SetString(PyExc_TypeError,
-                    "flint constructor one numeric argument");
-    return -1;
+    if (PyVectorcall_NARGS(nargsf) != 1) {
+        PyErr_SetString(PyExc_TypeError,
+                        "flint constructor one numeric argument");
+        return NULL;
+    }
+    if (pyflint_init_from_object(args[0], &f) < 0) {
+        return NULL;
+    }
+    return pyflint_from_flint(f);
 }
+#endif
 
 /// @brief The __repr__ printing method
 /// @return A python string representation of the tracked value
@@ -297,12 +452,27 @@ static Py_hash_t pyflint_hash(PyObject *self) {
 
 /// @brief The __reduce__ method reproduces the internal structure of the flint 
 ///        struct as object as PyObjects
-/// @return a Tuple with Type and a Tuple of the object members as PyObjects
+/// @return a Tuple with copyreg.__newobj__, a Tuple with the type, and a Tuple of the
+///         object members as PyObjects
+/// The flint is rebuilt with __new__ and __setstate__ rather than the constructor, so
+/// that any flint can be unpickled, even one whose components were set through the
+/// interval setter or a component view and do not satisfy a <= v <= b.
 static PyObject* pyflint_reduce(PyObject* self, PyObject* NPY_UNUSED(args)) {
-    return Py_BuildValue("O(OOO)", Py_TYPE(self),
-                         PyFloat_FromDouble(((PyFlint*) self)->obval.a),
-                         PyFloat_FromDouble(((PyFlint*) self)->obval.b),
-                         PyFloat_FromDouble(((PyFlint*) self)->obval.v));
+    PyObject* copyreg = NULL;
+    PyObject* newobj = NULL;
+    copyreg = PyImport_ImportModule("copyreg");
+    if (copyreg == NULL) {
+        return NULL;
+    }
+    newobj = PyObject_GetAttrString(copyreg, "__newobj__");
+    Py_DECREF(copyreg);
+    if (newobj == NULL) {
+        return NULL;
+    }
+    return Py_BuildValue("N(O)(ddd)", newobj, Py_TYPE(self),
+                         ((PyFlint*) self)->obval.a,
+                         ((PyFlint*) self)->obval.b,
+                         ((PyFlint*) self)->obval.v);
 }
 
 /// @brief The __getstate__ method builds the data member as PyObjects
@@ -312,10 +482,10 @@ static PyObject* pyflint_getstate(PyObject* self, PyObject* args) {
     if (!PyArg_ParseTuple(args, ":getstate")) {
         return NULL;
     }
-    return Py_BuildValue("OOO",
-                         PyFloat_FromDouble(((PyFlint*) self)->obval.a),
-                         PyFloat_FromDouble(((PyFlint*) self)->obval.b),
-                         PyFloat_FromDouble(((PyFlint*) self)->obval.v));
+    return Py_BuildValue("ddd",
+                         ((PyFlint*) self)->obval.a,
+                         ((PyFlint*) self)->obval.b,
+                         ((PyFlint*) self)->obval.v);
 } 
 
 /// @brief The __setstate__ reads in the data as pickled by __getstate__
@@ -336,6 +506,39 @@ static PyObject* pyflint_setstate(PyObject* self, PyObject* args) {
 // ------------------------------------
 // ---- Flint comparison operators ----
 // ------------------------------------
+/// @brief Compare a flint with a float through the flint_{op}_scalar functions
+/// @param f The flint to compare
+/// @param d The float to compare
+/// @param op An enum as an op-code for ==, !=, <, <=, >, >=
+/// @return A PyBool of Py_True if `f op d`, otherwise Py_False
+static PyObject* pyflint_richcomp_scalar(flint f, double d, int op) {
+    switch (op) {
+        case Py_EQ : {
+            return PyBool_FromLong(flint_eq_scalar(f, d));
+        }
+        case Py_NE : {
+            return PyBool_FromLong(flint_ne_scalar(f, d));
+        }
+        case Py_LT : {
+            return PyBool_FromLong(flint_lt_scalar(f, d));
+        }
+        case Py_LE : {
+            return PyBool_FromLong(flint_le_scalar(f, d));
+        }
+        case Py_GT : {
+            return PyBool_FromLong(flint_gt_scalar(f, d));
+        }
+        case Py_GE : {
+            return PyBool_FromLong(flint_ge_scalar(f, d));
+        }
+        default:
+            PyErr_SetString(PyExc_TypeError, 
+                "Supported comparison operators are ==, !=, <, <=, >, >=");
+            Py_INCREF(Py_NotImplemented);
+            return Py_NotImplemented;
+    }
+}
+
 /// @brief A rich comparison operator that implements __eq__, __ne__, __lt__, 
 ///        __le__, __gt__, and __ge__.
 /// @param a The first object to compare - should always be a PyFlint
@@ -348,20 +551,18 @@ static PyObject* pyflint_richcomp(PyObject* a, PyObject* b, int op) {
     PyFlint_CheckedGetFlint(f, a);
     // Comparisons can happen for all other numerical values
     flint fo = {0.0, 0.0, 0.0};
-    double d = 0.0;
-    PyObject* D = {0};
+    int ret = 0;
     if (PyFlint_Check(b)) { // check if its a flint already
         fo = ((PyFlint*) b)->obval;
-    } else { // otherwise try to cast into a float then a flint
-        D = PyNumber_Float(b);
-        if (!D) {
-            PyErr_SetString(PyExc_TypeError, 
-                "Comparison with PyFlint must be with numeric type");
-            Py_INCREF(Py_NotImplemented);
-            return Py_NotImplemented;
+    } else if (PyFloat_Check(b)) { // floats use the scalar comparisons
+        return pyflint_richcomp_scalar(f, PyFloat_AS_DOUBLE(b), op);
+    } else { // otherwise turn the number into a flint
+        ret = pyflint_number_to_flint(b, &fo);
+        if (ret < 0) {
+            return NULL;
+        } else if (ret == 0) {
+            Py_RETURN_NOTIMPLEMENTED;
         }
-        d = PyFloat_AsDouble(D);
-        fo = double_to_flint(d);
     }
     switch (op) {
         case Py_EQ : {
@@ -426,12 +627,39 @@ BINARY_FLINT_RETURNER(multiply)
 /// @param b The second number/flint
 /// @return a/b
 BINARY_FLINT_RETURNER(divide)
+/// @brief The _floordiv_ and _rfloordiv_ floor division method for intervals
+/// @param a The first number/flint
+/// @param b The second number/flint
+/// @return a//b
+BINARY_FLINT_RETURNER(floor_divide)
+/// @brief The _mod_ and _rmod_ remainder method for intervals
+/// @param a The first number/flint
+/// @param b The second number/flint
+/// @return a%b with the sign of b
+BINARY_FLINT_RETURNER(remainder)
 /// @brief The _pow_ or _rpow_ operator, evaluate a general power exponential
 /// @param a The base
 /// @param b The exponent
 /// @return The a**b
 BINARY_FLINT_RETURNER(power)
-BINARY_TO_TERTIARY(power)
+/// @brief The _pow_ operator with a python int exponent uses the integer power,
+///        anything else falls through to the general power
+/// @param a The base
+/// @param b The exponent
+/// @return The a**b
+static PyObject* pyflint_power_int(PyObject* a, PyObject* b) {
+    long long n = 0;
+    int overflow = 0;
+    if (PyFlint_Check(a) && PyLong_Check(b)) {
+        n = PyLong_AsLongLongAndOverflow(b, &overflow);
+        if (!overflow && !(n == -1 && PyErr_Occurred())) {
+            return PyFlint_FromFlint(flint_power_int(((PyFlint*) a)->obval, n));
+        }
+        PyErr_Clear();
+    }
+    return pyflint_power(a, b);
+}
+BINARY_TO_TERTIARY(power_int)
 /// @brief The _iadd_ addition operator for intervals
 /// @param a The first operand, value replaced with a+b
 /// @param b The second operand
@@ -453,7 +681,24 @@ BINARY_FLINT_INPLACE(divide)
 /// @param b The exponent
 /// @return The a**b
 BINARY_FLINT_INPLACE(power)
-BINARY_TO_TERTIARY_INPLACE(power)
+/// @brief The _ipow_ operator with a python int exponent uses the integer power
+/// @param a The base, value replaced with a**b
+/// @param b The exponent
+static PyObject* pyflint_inplace_power_int(PyObject* a, PyObject* b) {
+    long long n = 0;
+    int overflow = 0;
+    if (PyFlint_Check(a) && PyLong_Check(b)) {
+        n = PyLong_AsLongLongAndOverflow(b, &overflow);
+        if (!overflow && !(n == -1 && PyErr_Occurred())) {
+            flint_inplace_power_int(&(((PyFlint*) a)->obval), n);
+            Py_INCREF(a);
+            return a;
+        }
+        PyErr_Clear();
+    }
+    return pyflint_inplace_power(a, b);
+}
+BINARY_TO_TERTIARY_INPLACE(power_int)
 /// @brief The _float_ function to return a single float from the interval
 /// @param a The flint value
 /// @return The float value
@@ -472,7 +717,7 @@ static PyNumberMethods pyflint_as_number = {
     .nb_add = pyflint_add, // binaryfunc nb_add;
     .nb_subtract = pyflint_subtract, // binaryfunc nb_subtract;
     .nb_multiply = pyflint_multiply, // binaryfunc nb_multiply;
-    .nb_power = pyflint_b2t_power, // ternaryfunc nb_power;
+    .nb_power = pyflint_b2t_power_int, // ternaryfunc nb_power;
     .nb_negative = pyflint_negative, // unaryfunc nb_negative;
     .nb_positive = pyflint_positive, // unaryfunc nb_positive;
     .nb_absolute = pyflint_absolute, // unaryfunc nb_absolute;
@@ -481,7 +726,9 @@ static PyNumberMethods pyflint_as_number = {
     .nb_inplace_multiply = pyflint_inplace_multiply, // binaryfunc nb_inplace_multiply;
     .nb_true_divide = pyflint_divide, // binaryfunc nb_true_divide;
     .nb_inplace_true_divide = pyflint_inplace_divide, // binaryfunc nb_inplace_true_divide;
-    .nb_inplace_power = pyflint_b2t_inplace_power, // ternaryfunc np_inplace_power;
+    .nb_floor_divide = pyflint_floor_divide, // binaryfunc nb_floor_divide;
+    .nb_remainder = pyflint_remainder, // binaryfunc nb_remainder;
+    .nb_inplace_power = pyflint_b2t_inplace_power_int, // ternaryfunc np_inplace_power;
     .nb_float = pyflint_float, // unaryfunc np_float;
 };
 
@@ -528,6 +775,36 @@ UNARY_TO_SELF_METHOD(cbrt)
 /// @return The hypotenuse distance of the two intervals sqrt(a^2+b^2)
 BINARY_FLINT_RETURNER(hypot)
 BINARY_TO_SELF_METHOD(hypot)
+/// @brief Evaluate the fused multiply-add self*y + z
+/// @param self The PyFlint object
+/// @param args The factor y and the addend z, either PyFlints or numbers
+/// @param nargs The number of arguments, must be 2
+/// @return The fused multiply-add of the three intervals
+static PyObject* pyflint_fma_meth(PyObject* self, PyObject* const* args,
+                                  Py_ssize_t nargs) {
+    flint f[2];
+    Py_ssize_t i = 0;
+    int ret = 0;
+    if (nargs != 2) {
+        PyErr_SetString(PyExc_TypeError, "fma takes exactly two arguments");
+        return NULL;
+    }
+    for (i=0; i<2; i++) {
+        if (PyFlint_Check(args[i])) {
+            f[i] = ((PyFlint*) args[i])->obval;
+        } else {
+            ret = pyflint_number_to_flint(args[i], &f[i]);
+            if (ret == 0) {
+                PyErr_SetString(PyExc_TypeError,
+                    "Binary operations for functions with PyFlint must be with numeric type");
+            }
+            if (ret != 1) {
+                return NULL;
+            }
+        }
+    }
+    return PyFlint_FromFlint(flint_fma(((PyFlint*) self)->obval, f[0], f[1]));
+}
 /// @brief Evaluate the exponential of the interval
 /// @param a The PyFlint object
 /// @return The exponential of the interval
@@ -629,6 +906,32 @@ UNARY_TO_SELF_METHOD(acosh)
 /// @return The inverse hyperbolic tangent of the interval
 UNARY_FLINT_RETURNER(atanh)
 UNARY_TO_SELF_METHOD(atanh)
+/// @brief Round the interval down to an integer
+/// @param a The PyFlint object
+/// @return The largest integers not greater than the interval
+UNARY_FLINT_RETURNER(floor)
+UNARY_TO_SELF_METHOD(floor)
+/// @brief Round the interval up to an integer
+/// @param a The PyFlint object
+/// @return The smallest integers not less than the interval
+UNARY_FLINT_RETURNER(ceil)
+UNARY_TO_SELF_METHOD(ceil)
+/// @brief Round the interval towards zero to an integer
+/// @param a The PyFlint object
+/// @return The integer parts of the interval
+UNARY_FLINT_RETURNER(trunc)
+UNARY_TO_SELF_METHOD(trunc)
+/// @brief Round the interval to the nearest integer
+/// @param a The PyFlint object
+/// @return The nearest integers to the interval
+UNARY_FLINT_RETURNER(rint)
+UNARY_TO_SELF_METHOD(rint)
+/// @brief Evaluate the remainder of the division of two intervals
+/// @param a The dividend PyFlint object
+/// @param b The divisor PyFlint object
+/// @return The remainder of a/b with the sign of a
+BINARY_FLINT_RETURNER(fmod)
+BINARY_TO_SELF_METHOD(fmod)
 
 
 // ---------------------------------------
@@ -660,8 +963,10 @@ PyMethodDef pyflint_methods[] = {
     "Evaluate the square root of the interval"},
     {"cbrt", pyflint_cbrt_meth, METH_NOARGS,
     "Evaluate the cube root of the interval"},
-    {"hypot", pyflint_hypot_meth, METH_VARARGS,
+    {"hypot", (PyCFunction)(void(*)(void)) pyflint_hypot_meth, METH_FASTCALL,
     "Evaluate the hypotenuse distance with the two intervals"},
+    {"fma", (PyCFunction)(void(*)(void)) pyflint_fma_meth, METH_FASTCALL,
+    "Evaluate the fused multiply-add self*y + z, rounding each boundary once"},
     {"exp", pyflint_exp_meth, METH_NOARGS,
     "Evaluate the exponential func of an interval"},
     {"exp2", pyflint_exp2_meth, METH_NOARGS,
@@ -688,7 +993,7 @@ PyMethodDef pyflint_methods[] = {
     "Evaluate the inverse cosine of the interval"},
     {"arctan", pyflint_atan_meth, METH_NOARGS,
     "Evaluate the inverse tangent of the interval"},
-    {"arctan2", pyflint_atan2_meth, METH_VARARGS,
+    {"arctan2", (PyCFunction)(void(*)(void)) pyflint_atan2_meth, METH_FASTCALL,
     "Evalute the two-input inverse tangent of the intervals"},
     {"sinh", pyflint_sinh_meth, METH_NOARGS,
     "Evaluate the hyperbolic sine of the interval"},
@@ -702,6 +1007,16 @@ PyMethodDef pyflint_methods[] = {
     "Evaluate the inverse hyperbolic cosine of the interval"},
     {"arctanh", pyflint_atanh_meth, METH_NOARGS,
     "Evaluate the inverse hyperbolic tangent of the interval"},
+    {"floor", pyflint_floor_meth, METH_NOARGS,
+    "Round the interval down to an integer"},
+    {"ceil", pyflint_ceil_meth, METH_NOARGS,
+    "Round the interval up to an integer"},
+    {"trunc", pyflint_trunc_meth, METH_NOARGS,
+    "Round the interval towards zero to an integer"},
+    {"rint", pyflint_rint_meth, METH_NOARGS,
+    "Round the interval to the nearest integer"},
+    {"fmod", (PyCFunction)(void(*)(void)) pyflint_fmod_meth, METH_FASTCALL,
+    "Evaluate the remainder of the division with the sign of the interval"},
     // sentinel
     {NULL, NULL, 0, NULL}
 };
@@ -801,8 +1116,9 @@ PyGetSetDef pyflint_getset[] = {
 /// @brief The Custom type structure for the new Flint object
 static PyTypeObject PyFlint_Type = {
     PyVarObject_HEAD_INIT(NULL, 0) // PyObject_VAR_HEAD
-    .tp_name = "flint", // const char *tp_name; /* For printing, in format "<module>.<name>" */
+    .tp_name = "flint.flint", // const char *tp_name; /* For printing, in format "<module>.<name>" */
     .tp_basicsize = sizeof(PyFlint), //Py_ssize_t tp_basicsize, tp_itemsize; /* For allocation */
+    .tp_dealloc = pyflint_dealloc, // destructor tp_dealloc;
     .tp_repr = pyflint_repr, // reprfunc tp_repr;
     .tp_as_number = &pyflint_as_number, // PyNumberMethods *tp_as_number;
     .tp_hash = pyflint_hash, // hashfunc tp_hash;
@@ -817,9 +1133,57 @@ static PyTypeObject PyFlint_Type = {
     // struct _typeobject *tp_base;
     .tp_init = pyflint_init, // initproc tp_init;
     .tp_new = pyflint_new, //newfunc tp_new;
+#if PY_VERSION_HEX >= 0x03090000
+    .tp_vectorcall = pyflint_vectorcall, // vectorcallfunc tp_vectorcall;
+#endif
     // unsigned int tp_version_tag;
 };
 
+// --------------------------------------------
+// ---- Flint32 custom type implementation ----
+// --------------------------------------------
+// The flint32 scalars are flints whose bounds and tracked value are all floats, so they
+// go in and out of flint32 arrays unchanged. They are a subclass of flint and inherit
+// all of its methods, which do the math in double precision and return regular flints.
+static PyTypeObject PyFlint32_Type;
+
+/// @brief Create a new flint32 scalar from a c flint32 struct
+/// @param f The c flint32 struct
+/// @return A new flint32 PyFlint object that contains the widened value of f
+static PyObject* pyflint32_from_flint32(flint32 f) {
+    PyFlint* p = (PyFlint*) PyFlint32_Type.tp_alloc(&PyFlint32_Type, 0);
+    if (p == NULL) {
+        return NULL;
+    }
+    p->obval = flint32_to_flint(f);
+    return (PyObject*) p;
+}
+
+/// @brief The __init__ initializing constructor, which rounds the interval out to floats
+/// @param self The object to be initialized
+/// @param args A tuple containing 1 PyObject with either a flint, float, or int
+/// @param kwargs An empty tuple
+/// @return 0 on success, -1 on failure
+static int pyflint32_init(PyObject* self, PyObject* args, PyObject* kwargs) {
+    flint* f = &(((PyFlint*) self)->obval);
+    if (pyflint_init(self, args, kwargs) < 0) {
+        return -1;
+    }
+    *f = flint32_to_flint(flint_to_flint32(*f));
+    return 0;
+}
+
+/// @brief The Custom type structure for the flint32 scalars
+/// The base type is set to PyFlint_Type in the module initialization function
+static PyTypeObject PyFlint32_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "flint.flint32",
+    .tp_basicsize = sizeof(PyFlint),
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+    .tp_doc = "A flint with single precision bounds and tracked value",
+    .tp_init = pyflint32_init,
+};
+
 
 // ##########################################
 // ---- End of standard Python Extension ----
@@ -829,6 +1193,49 @@ static PyTypeObject PyFlint_Type = {
 // ---- NumPy support ----
 // #######################
 
+// ------------------------
+// ---- Vector kernels ----
+// ------------------------
+// The vector kernels are compiled from the flint_simd.h template once for every
+// instruction set, and the widest one that the cpu supports is picked when the module
+// is imported. The baseline copy uses whatever the compiler targets by default, which
+// is NEON on aarch64 and SSE2 on x86-64. The wider x86 copies need the gcc/clang
+// target attribute, and the avx2 copy also turns on the fused multiply-add
+// instructions that every cpu with avx2 has. Those two copies fuse the row
+// multiply-adds of matmul, the baseline copy only does with a hardware fma.
+#define FLINT_SIMD_NAME(name) flint_simd_##name##_baseline
+#define FLINT_SIMD_TARGET
+#define FLINT_SIMD_ISA "baseline"
+#include "flint_simd.h"
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define NPYFLINT_SIMD_X86
+#define FLINT_SIMD_NAME(name) flint_simd_##name##_avx2
+#define FLINT_SIMD_TARGET __attribute__((target("avx2,fma")))
+#define FLINT_SIMD_ISA "avx2"
+#define FLINT_SIMD_FMA 1
+#include "flint_simd.h"
+#define FLINT_SIMD_NAME(name) flint_simd_##name##_avx512f
+#define FLINT_SIMD_TARGET __attribute__((target("avx512f")))
+#define FLINT_SIMD_ISA "avx512f"
+#define FLINT_SIMD_FMA 1
+#include "flint_simd.h"
+#endif
+
+/// @brief The vector kernels used by the ufunc loops
+static const flint_simd_kernels* npyflint_simd = &flint_simd_kernels_baseline;
+
+/// @brief Pick the vector kernels for the widest instruction set the cpu supports
+static void npyflint_simd_select(void) {
+#ifdef NPYFLINT_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        npyflint_simd = &flint_simd_kernels_avx512f;
+    } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        npyflint_simd = &flint_simd_kernels_avx2;
+    }
+#endif
+}
+
 // -------------------------------------
 // ---- NumPy NewType Array Methods ----
 // -------------------------------------
@@ -849,69 +1256,90 @@ static PyObject* npyflint_getitem(void* data, void* arr) {
 /// @return 0 on success -1 on failure
 static int npyflint_setitem(PyObject* item, void* data, void* arr) {
     flint f = {0.0, 0.0, 0.0};
-    PyObject* D = {0};
+    int ret = 0;
     if (PyFlint_Check(item)) {
         f = ((PyFlint*) item)->obval;
     } else {
-        D = PyNumber_Float(item);
-        if (D == NULL) {
+        ret = pyflint_number_to_flint(item, &f);
+        if (ret == 0) {
             PyErr_SetString(PyExc_TypeError,
                 "expected flint or numeric type.");
+        }
+        if (ret != 1) {
             return -1;
         }
-        f = double_to_flint(PyFloat_AsDouble(D));
-        Py_DECREF(D);
     }
     memcpy(data, &f, sizeof(flint));
     return 0;
 }
 
+/// @brief Reverse the byte order of a 64 bit word, written so that compilers turn it
+/// into a single byte swap instruction
+static inline npy_uint64 npyflint_bswap64(npy_uint64 x) {
+    x = (x << 32) | (x >> 32);
+    x = ((x & 0x0000FFFF0000FFFFULL) << 16) | ((x >> 16) & 0x0000FFFF0000FFFFULL);
+    x = ((x & 0x00FF00FF00FF00FFULL) << 8) | ((x >> 8) & 0x00FF00FF00FF00FFULL);
+    return x;
+}
+
+/// @brief Copy one flint from src to dst, swapping the byte order of each double
+/// @param dst A pointer to the destination, which may be unaligned
+/// @param src A pointer to the source, which may be unaligned or equal to dst
+static inline void npyflint_copy_swapped(char* dst, const char* src) {
+    npy_uint64 u[3];
+    memcpy(u, src, sizeof(flint));
+    u[0] = npyflint_bswap64(u[0]);
+    u[1] = npyflint_bswap64(u[1]);
+    u[2] = npyflint_bswap64(u[2]);
+    memcpy(dst, u, sizeof(flint));
+}
+
 /// @brief Copy an element of an ndarray from src to dst, possibly swapping
-///        Utilizes the existing copyswap function for doubles
 /// @param dst A pointer to the destination
-/// @param src A pointer to the source
+/// @param src A pointer to the source, or NULL to only swap dst in place
 /// @param swap A flag to swap data, or simply copy
 /// @param arr A pointer to the full array
-static void npyflint_copyswap(void* dst, void* src, int swap, void* arr) {
-    // Get a pointer to the array description for doubles
-    PyArray_Descr* descr = PyArray_DescrFromType(NPY_DOUBLE);
-    // Call the double copyswap rountine for an flint sized array (3) 
-    descr->f->copyswapn(dst, sizeof(double), src, sizeof(double), 
-                        sizeof(flint)/sizeof(double), swap, arr);
-    Py_DECREF(descr);
+static void npyflint_copyswap(void* dst, void* src, int swap, void* NPY_UNUSED(arr)) {
+    if (swap) {
+        npyflint_copy_swapped((char*) dst, (src == NULL) ? (char*) dst : (char*) src);
+    } else if (src != NULL) {
+        memmove(dst, src, sizeof(flint));
+    }
 }
 
 /// @brief Copy a section of an ndarray from src to dst, possibly swapping
-///        Utilizes the existing copyswap function for doubles
 /// @param dst A pointer to the destination
 /// @param dstride The number of bytes between entries in the destination array
-/// @param src A pointer to the source
+/// @param src A pointer to the source, or NULL to only swap dst in place
 /// @param sstride The number of bytes between entries in the source array
 /// @param n The number of elements to copy
 /// @param swap A flag to swap data, or simply copy
 /// @param arr A pointer to the full array
 static void npyflint_copyswapn(void* dst, npy_intp dstride,
                                void* src, npy_intp sstride,
-                               npy_intp n, int swap, void* arr) {
-    // Cast the destination and source points into flint type
-    flint* _dst = (flint*) dst;
-    flint* _src = (flint*) src;
-    // Grab a copy of the 
-    PyArray_Descr* descr = PyArray_DescrFromType(NPY_DOUBLE);
-    // If the stride is represents a contiguous array do a single call
-    if (dstride == sizeof(flint) && sstride == sizeof(flint)) {
-        descr->f->copyswapn(dst, sizeof(double), src, sizeof(double), 
-                            n*sizeof(flint)/sizeof(double), swap, arr);
+                               npy_intp n, int swap, void* NPY_UNUSED(arr)) {
+    char* _dst = (char*) dst;
+    char* _src = (char*) src;
+    npy_intp i;
+    if (_src == NULL) {
+        // Only swap the destination in place
+        _src = _dst;
+        sstride = dstride;
+        if (!swap) {
+            return;
+        }
+    }
+    if (swap) {
+        for (i = 0; i < n; i++) {
+            npyflint_copy_swapped(_dst + i*dstride, _src + i*sstride);
+        }
+    } else if (dstride == sizeof(flint) && sstride == sizeof(flint)) {
+        memmove(_dst, _src, n*sizeof(flint));
     } else {
-        // Else we make a call for each double in the struct
-        descr->f->copyswapn(&(_dst->a), dstride, &(_src->a), sstride, 
-                            n, swap, arr);
-        descr->f->copyswapn(&(_dst->b), dstride, &(_src->b), sstride, 
-                            n, swap, arr);
-        descr->f->copyswapn(&(_dst->v), dstride, &(_src->v), sstride, 
-                            n, swap, arr);
+        for (i = 0; i < n; i++) {
+            memmove(_dst + i*dstride, _src + i*sstride, sizeof(flint));
+        }
     }
-    Py_DECREF(descr);
 }
 
 /// @brief Check if an element of a numpy array is zero
@@ -925,121 +1353,363 @@ static void npyflint_copyswapn(void* dst, npy_intp dstride,
 /// I've decided to use the first definition.
 static npy_bool npyflint_nonzero(void* data, void* arr) {
     flint f = {0.0, 0.0, 0.0};
-    memcpy(data, &f, sizeof(flint));
+    memcpy(&f, data, sizeof(flint));
     return (f.a==0.0 && f.b==0.0 && f.v==0.0)?NPY_FALSE:NPY_TRUE;
     // return flint_nonzero(f)?NPY_TRUE:NPY_FALSE;
 }
 
+/// @brief Check if one flint comes before another in the sort order
+/// The flints are ordered by lower bound, then upper bound, then tracked value. This
+/// is only valid for flints without NaN components, which are put at the end of the
+/// array before sorting.
+/// @param x A pointer to the first flint
+/// @param y A pointer to the second flint
+/// @return 1 if x comes before y, 0 otherwise
+static inline int npyflint_sort_lt(const flint* x, const flint* y) {
+    if (x->a != y->a) {
+        return x->a < y->a;
+    }
+    if (x->b != y->b) {
+        return x->b < y->b;
+    }
+    return x->v < y->v;
+}
+
 /// @brief Compare two elements of a numpy array
+/// This uses the same order as the sort functions below, so that it can be used by
+/// NumPy for searchsorted on sorted arrays. Flints that contain NaN come last.
 /// @param d1 A pointer to the first element
 /// @param d1 A pointer to the second element
 /// @param arr A pointer to the array
 /// @return 1 if *d1 > *d2, 0 if *d1 == *d2, -1 if *d1 < d2*
-static int npyflint_compare(const void* d1, const void* d2, void* arr) {
-    int ret;
-    flint fp1 = *((flint*) d1);
-    flint fp2 = *((flint*) d2);
-    npy_bool dnan1 = flint_isnan(fp1);
-    npy_bool dnan2 = flint_isnan(fp2);
-    if (dnan1) {
-        ret = dnan2 ? 0 : -1;
-    } else if (dnan2) {
-        ret = 1;
-    } else if (fp1.b < fp2.a) {
-        ret = -1;
-    } else if (fp1.a > fp2.b) {
-        ret = 1;
-    } else {
-        ret = 0;
+static int npyflint_compare(const void* d1, const void* d2, void* NPY_UNUSED(arr)) {
+    flint f1, f2;
+    int nan1, nan2;
+    memcpy(&f1, d1, sizeof(flint));
+    memcpy(&f2, d2, sizeof(flint));
+    nan1 = flint_isnan(f1);
+    nan2 = flint_isnan(f2);
+    if (nan1 || nan2) {
+        return nan1 - nan2;
     }
-    return ret;
+    return npyflint_sort_lt(&f2, &f1) - npyflint_sort_lt(&f1, &f2);
 }
 
-/// @brief Find the index of the max element of the array
-/// @param data A pointer to the first elemetn in the array to check
-/// @param n The number of elements to check
-/// @param max_ind A pointer to an int, the max will be written here
-/// @return Always returns 0;
-///
-/// Note: Since the comparisons with flints is inexact, I've chose to use this
-/// to find the index of the flint with the largest upper limit.
-static int npyflint_argmax(void* data, npy_intp n, 
-                           npy_intp* max_ind, void* arr) {
-    if (n==0) {
-        return 0;
-    }
-    flint* fdata = (flint*) data;
-    npy_intp i = 0;
-    double max = fdata[i].b;
-    *max_ind = 0;
-    for (i=0; i<n; i++) {
-        if (fdata[i].b > max) {
-            max = fdata[i].b;
-            *max_ind = i;
-        }
+// ,,,,,,,,,,,,,,,,,
+// ---- Sorting ----
+// `````````````````
+// The sort and argsort functions are generated for two element types, the flints
+// themselves and indices into an array of flints. Both first move the flints with
+// NaN components to the end, then sort the rest with an introsort (quicksort that
+// falls back to heapsort), a heapsort, or a stable mergesort.
+/// @brief Below this size the sorts finish with an insertion sort
+#define NPYFLINT_SMALL_SORT 16
+
+/// @brief The flint an element refers to, for the flints themselves and for indices
+#define NPYFLINT_SORT_VAL(x, v) (&(x))
+#define NPYFLINT_SORT_IDX(x, v) (&(v)[x])
+
+/// @brief A macro to define the sort functions for one element type
+/// @param name The suffix for the function names
+/// @param type The element type
+/// @param key A macro that gets the flint pointer of an element
+#define NPYFLINT_SORT_FUNCS(name, type, key) \
+static inline int npyflint_lt_##name(type x, type y, const flint* v) { \
+    return npyflint_sort_lt(key(x, v), key(y, v)); \
+} \
+static npy_intp npyflint_nan_to_end_##name(type* s, npy_intp n, const flint* v) { \
+    npy_intp i, m = n; \
+    type t; \
+    for (i = 0; i < m; i++) { \
+        if (flint_isnan(*key(s[i], v))) { \
+            m--; \
+            t = s[i]; s[i] = s[m]; s[m] = t; \
+            i--; \
+        } \
+    } \
+    return m; \
+} \
+static npy_intp npyflint_stable_nan_to_end_##name(type* s, npy_intp n, type* buf, \
+                                                  const flint* v) { \
+    npy_intp i, m = 0, k = 0; \
+    for (i = 0; i < n; i++) { \
+        if (flint_isnan(*key(s[i], v))) { \
+            buf[k++] = s[i]; \
+        } else { \
+            s[m++] = s[i]; \
+        } \
+    } \
+    memcpy(s + m, buf, k*sizeof(type)); \
+    return m; \
+} \
+static void npyflint_insertion_sort_##name(type* s, npy_intp n, const flint* v) { \
+    npy_intp i, j; \
+    type t; \
+    for (i = 1; i < n; i++) { \
+        t = s[i]; \
+        for (j = i; j > 0 && npyflint_lt_##name(t, s[j-1], v); j--) { \
+            s[j] = s[j-1]; \
+        } \
+        s[j] = t; \
+    } \
+} \
+static void npyflint_sift_down_##name(type* s, npy_intp i, npy_intp n, const flint* v) { \
+    npy_intp j; \
+    type t = s[i]; \
+    for (j = 2*i+1; j < n; i = j, j = 2*i+1) { \
+        if (j+1 < n && npyflint_lt_##name(s[j], s[j+1], v)) { \
+            j++; \
+        } \
+        if (!npyflint_lt_##name(t, s[j], v)) { \
+            break; \
+        } \
+        s[i] = s[j]; \
+    } \
+    s[i] = t; \
+} \
+static void npyflint_heapsort_##name(type* s, npy_intp n, const flint* v) { \
+    npy_intp i; \
+    type t; \
+    for (i = n/2; i > 0; i--) { \
+        npyflint_sift_down_##name(s, i-1, n, v); \
+    } \
+    for (i = n-1; i > 0; i--) { \
+        t = s[i]; s[i] = s[0]; s[0] = t; \
+        npyflint_sift_down_##name(s, 0, i, v); \
+    } \
+} \
+static void npyflint_introsort_##name(type* s, npy_intp n, int depth, const flint* v) { \
+    npy_intp i, j; \
+    type pivot, t; \
+    while (n > NPYFLINT_SMALL_SORT) { \
+        if (depth-- == 0) { \
+            npyflint_heapsort_##name(s, n, v); \
+            return; \
+        } \
+        /* median of three pivot, also sentinels for the partition */ \
+        j = n/2; \
+        if (npyflint_lt_##name(s[j], s[0], v)) { t = s[j]; s[j] = s[0]; s[0] = t; } \
+        if (npyflint_lt_##name(s[n-1], s[j], v)) { \
+            t = s[j]; s[j] = s[n-1]; s[n-1] = t; \
+            if (npyflint_lt_##name(s[j], s[0], v)) { t = s[j]; s[j] = s[0]; s[0] = t; } \
+        } \
+        pivot = s[j]; \
+        /* Hoare partition into [0, j] and [j+1, n) */ \
+        i = -1; \
+        j = n; \
+        for (;;) { \
+            do { i++; } while (npyflint_lt_##name(s[i], pivot, v)); \
+            do { j--; } while (npyflint_lt_##name(pivot, s[j], v)); \
+            if (i >= j) { \
+                break; \
+            } \
+            t = s[i]; s[i] = s[j]; s[j] = t; \
+        } \
+        /* recurse into the smaller part and loop on the larger one */ \
+        if (j+1 < n-j-1) { \
+            npyflint_introsort_##name(s, j+1, depth, v); \
+            s += j+1; \
+            n -= j+1; \
+        } else { \
+            npyflint_introsort_##name(s+j+1, n-j-1, depth, v); \
+            n = j+1; \
+        } \
+    } \
+    npyflint_insertion_sort_##name(s, n, v); \
+} \
+static void npyflint_mergesort_##name(type* s, npy_intp n, type* buf, const flint* v) { \
+    npy_intp h, i, j, k; \
+    if (n <= NPYFLINT_SMALL_SORT) { \
+        npyflint_insertion_sort_##name(s, n, v); \
+        return; \
+    } \
+    h = n/2; \
+    npyflint_mergesort_##name(s, h, buf, v); \
+    npyflint_mergesort_##name(s+h, n-h, buf, v); \
+    if (!npyflint_lt_##name(s[h], s[h-1], v)) { \
+        return; \
+    } \
+    memcpy(buf, s, h*sizeof(type)); \
+    for (i = 0, j = h, k = 0; i < h && j < n; k++) { \
+        s[k] = npyflint_lt_##name(s[j], buf[i], v) ? s[j++] : buf[i++]; \
+    } \
+    memcpy(s+k, buf+i, (h-i)*sizeof(type)); \
+}
+NPYFLINT_SORT_FUNCS(val, flint, NPYFLINT_SORT_VAL)
+NPYFLINT_SORT_FUNCS(idx, npy_intp, NPYFLINT_SORT_IDX)
+
+/// @brief The introsort recursion depth before falling back to heapsort
+static int npyflint_sort_depth(npy_intp n) {
+    int depth = 0;
+    while (n > 1) {
+        n >>= 1;
+        depth += 2;
     }
+    return depth;
+}
+
+/// @brief Sort a contiguous array of flints with an introsort
+/// @param start A pointer to the first element
+/// @param n The number of elements
+/// @param arr A pointer to the full array
+/// @return 0 on success
+static int npyflint_quicksort(void* start, npy_intp n, void* NPY_UNUSED(arr)) {
+    flint* s = (flint*) start;
+    n = npyflint_nan_to_end_val(s, n, NULL);
+    npyflint_introsort_val(s, n, npyflint_sort_depth(n), NULL);
     return 0;
 }
 
-/// @brief Find the index of the min element of the array
-/// @param data A pointer to the first elemetn in the array to check
-/// @param n The number of elements to check
-/// @param min_ind A pointer to an int, the min will be written here
-/// @return Always returns 0;
-///
-/// Note: Since the comparisons with flints is inexact, I've chose to use this
-/// to find the index of the flint with the smallest lower limit.
-static int npyflint_argmin(void* data, npy_intp n, 
-                           npy_intp* min_ind, void* arr) {
-    if (n==0) {
-        return 0;
-    }
-    flint* fdata = (flint*) data;
-    npy_intp i = 0;
-    double min = fdata[i].b;
-    *min_ind = 0;
-    for (i=0; i<n; i++) {
-        if (fdata[i].b < min) {
-            min = fdata[i].b;
-            *min_ind = i;
-        }
+/// @brief Sort a contiguous array of flints with a heapsort
+static int npyflint_heapsort(void* start, npy_intp n, void* NPY_UNUSED(arr)) {
+    flint* s = (flint*) start;
+    n = npyflint_nan_to_end_val(s, n, NULL);
+    npyflint_heapsort_val(s, n, NULL);
+    return 0;
+}
+
+/// @brief Sort a contiguous array of flints with a stable mergesort
+/// @return 0 on success, -1 if the work buffer could not be allocated
+static int npyflint_mergesort(void* start, npy_intp n, void* NPY_UNUSED(arr)) {
+    flint* s = (flint*) start;
+    flint* buf = (flint*) malloc((n > 0 ? n : 1)*sizeof(flint));
+    if (buf == NULL) {
+        return -1;
     }
+    n = npyflint_stable_nan_to_end_val(s, n, buf, NULL);
+    npyflint_mergesort_val(s, n, buf, NULL);
+    free(buf);
     return 0;
 }
 
-/// @brief Compute the dot product between two arrays of flint
-/// @param d1 A pointer to the first element of the first array
-/// @param s1 A distance between data element of the first array in bytes
-/// @param d2 A pointer to the first element of the second array
-/// @param s1 A distance between data element of the second array inbytes
-/// @param res A pointer to a flint, will hold the result
-/// @param n The number of elements to use in calcuating the dot product
-/// @param arr A pointer to the full array? (even for two arrays?)
-static void npyflint_dotfunc(void* d1, npy_intp s1,
-                             void* d2, npy_intp s2, 
-                             void* res, npy_intp n, void* arr) {
-    uint8_t* fp1 = (uint8_t*) d1;
-    uint8_t* fp2 = (uint8_t*) d2;
-    flint _fres = {0.0, 0.0, 0.0};
-    flint* fres = (flint*) res;
-    npy_intp i = 0;
-    for (i=0; i<n; i++) {
-        flint_inplace_add(
-            &_fres, 
-            flint_multiply(
-                *((flint*) fp1), 
-                *((flint*) fp2)
-            )
-        );
-        fp1 += s1;
-        fp2 += s2;
+/// @brief Sort the indices of a contiguous array of flints with an introsort
+/// @param data A pointer to the first flint
+/// @param tosort The indices to sort, in place
+/// @param n The number of indices
+/// @param arr A pointer to the full array
+/// @return 0 on success
+static int npyflint_aquicksort(void* data, npy_intp* tosort, npy_intp n,
+                               void* NPY_UNUSED(arr)) {
+    const flint* v = (const flint*) data;
+    n = npyflint_nan_to_end_idx(tosort, n, v);
+    npyflint_introsort_idx(tosort, n, npyflint_sort_depth(n), v);
+    return 0;
+}
+
+/// @brief Sort the indices of a contiguous array of flints with a heapsort
+static int npyflint_aheapsort(void* data, npy_intp* tosort, npy_intp n,
+                              void* NPY_UNUSED(arr)) {
+    const flint* v = (const flint*) data;
+    n = npyflint_nan_to_end_idx(tosort, n, v);
+    npyflint_heapsort_idx(tosort, n, v);
+    return 0;
+}
+
+/// @brief Sort the indices of a contiguous array of flints with a stable mergesort
+/// @return 0 on success, -1 if the work buffer could not be allocated
+static int npyflint_amergesort(void* data, npy_intp* tosort, npy_intp n,
+                               void* NPY_UNUSED(arr)) {
+    const flint* v = (const flint*) data;
+    npy_intp* buf = (npy_intp*) malloc((n > 0 ? n : 1)*sizeof(npy_intp));
+    if (buf == NULL) {
+        return -1;
     }
-    *fres = _fres;
+    n = npyflint_stable_nan_to_end_idx(tosort, n, buf, v);
+    npyflint_mergesort_idx(tosort, n, buf, v);
+    free(buf);
+    return 0;
 }
 
-/// @brief Fill an array based on it's first two elements
+/// @brief Find the index of the largest element in a contiguous array of flints
+/// The largest element is the first one with the largest upper bound, or the first one
+/// with NaN components if there are any, the same as for NumPy floats.
 /// @param data A pointer to the first element
-/// @param n The number of element to fill in
+/// @param n The number of elements
+/// @param max_ind A pointer to the index to fill
+/// @param arr A pointer to the full array
+/// @return 0 on success
+static int npyflint_argmax(void* data, npy_intp n,
+                           npy_intp* max_ind, void* NPY_UNUSED(arr)) {
+    if (n > 0) {
+        *max_ind = npyflint_simd->argmax((const flint*) data, n);
+    }
+    return 0;
+}
+
+/// @brief Find the index of the smallest element in a contiguous array of flints
+/// The smallest element is the first one with the smallest lower bound, or the first
+/// one with NaN components if there are any.
+/// @param data A pointer to the first element
+/// @param n The number of elements
+/// @param min_ind A pointer to the index to fill
+/// @param arr A pointer to the full array
+/// @return 0 on success
+static int npyflint_argmin(void* data, npy_intp n,
+                           npy_intp* min_ind, void* NPY_UNUSED(arr)) {
+    if (n > 0) {
+        *min_ind = npyflint_simd->argmin((const flint*) data, n);
+    }
+    return 0;
+}
+
+/// @brief The number of independent partial sums in a dot product
+#define NPYFLINT_DOT_LANES 4
+
+/// @brief Compute the dot product between two strided arrays of flints
+/// The products are added into several independent partial sums with
+/// flint_inplace_madd, and the partial sums are combined pairwise at the end, so
+/// consecutive terms do not have to wait on each other.
+/// @param x A pointer to the first element of the first array
+/// @param sx The distance between elements of the first array in bytes
+/// @param y A pointer to the first element of the second array
+/// @param sy The distance between elements of the second array in bytes
+/// @param n The number of elements in each array
+/// @return The sum of the products, zero if n is 0
+static flint npyflint_dot(const char* x, npy_intp sx,
+                          const char* y, npy_intp sy, npy_intp n) {
+    flint s[NPYFLINT_DOT_LANES];
+    npy_intp i = 0, j = 0, lanes = (n < NPYFLINT_DOT_LANES) ? n : NPYFLINT_DOT_LANES;
+    if (n == 0) {
+        flint zero = {0.0, 0.0, 0.0};
+        return zero;
+    }
+    for (j=0; j<lanes; j++) {
+        s[j] = flint_multiply(*((const flint*) (x + j*sx)), *((const flint*) (y + j*sy)));
+    }
+    for (i=lanes; i+NPYFLINT_DOT_LANES<=n; i+=NPYFLINT_DOT_LANES) {
+        for (j=0; j<NPYFLINT_DOT_LANES; j++) {
+            flint_inplace_madd(&s[j], *((const flint*) (x + (i+j)*sx)),
+                              *((const flint*) (y + (i+j)*sy)));
+        }
+    }
+    for (; i<n; i++) {
+        flint_inplace_madd(&s[0], *((const flint*) (x + i*sx)), *((const flint*) (y + i*sy)));
+    }
+    for (; lanes>1; lanes=(lanes+1)/2) {
+        for (j=0; j<lanes/2; j++) {
+            flint_inplace_add(&s[j], s[j+(lanes+1)/2]);
+        }
+    }
+    return s[0];
+}
+
+/// @brief Compute the dot product between two arrays of flint
+/// @param d1 A pointer to the first element of the first array
+/// @param s1 A distance between data element of the first array in bytes
+/// @param d2 A pointer to the first element of the second array
+/// @param s1 A distance between data element of the second array inbytes
+/// @param res A pointer to a flint, will hold the result
+/// @param n The number of elements to use in calcuating the dot product
+/// @param arr A pointer to the full array? (even for two arrays?)
+static void npyflint_dotfunc(void* d1, npy_intp s1,
+                             void* d2, npy_intp s2, 
+                             void* res, npy_intp n, void* arr) {
+    *((flint*) res) = npyflint_dot((const char*) d1, s1, (const char*) d2, s2, n);
+}
+
+/// @brief Fill an array based on it's first two elements
+/// @param data A pointer to the first element
+/// @param n The number of element to fill in
 /// @param arr A pointer to the full array
 /// @return ??
 static int npyflint_fill(void* data, npy_intp n, void* arr) {
@@ -1071,6 +1741,112 @@ static int npyflint_fillwithscalar(void* buffer, npy_intp n,
     return 0;
 }
 
+// ------------------------------
+// ---- performance counters ----
+// ------------------------------
+// The counters are compiled in but off until they are turned on with flint.set_stats
+// or the FLINT_STATS environment variable. While they are on, every ufunc loop adds its
+// calls, elements, and time to its own counter, every cast adds its calls and elements,
+// and the loops with flint or flint32 results add the widths b-a of the results to a
+// histogram. While they are off, each loop or cast call only checks a single flag.
+
+/// @brief The number of bins in the width histogram
+/// Bin 0 counts zero widths, bin e+1074 counts the widths in [2^(e-1), 2^e), and the
+/// last bin counts the infinite and nan widths.
+#define NPYFLINT_STATS_BINS 2100
+
+/// @brief The counters of a ufunc loop or a cast
+typedef struct npyflint_stats_entry {
+    const char* name;
+    npy_int64 calls;
+    npy_int64 elements;
+    double seconds;
+    /// The counters that have been used are kept in a list
+    struct npyflint_stats_entry* next;
+    int used;
+} npyflint_stats_entry;
+
+/// @brief True if the counters are on
+static int npyflint_stats_enabled = 0;
+/// @brief Guards all of the counters
+static PyThread_type_lock npyflint_stats_lock = NULL;
+/// @brief The list of the ufunc loop counters that have been used
+static npyflint_stats_entry* npyflint_stats_loops = NULL;
+/// @brief The list of the cast counters that have been used
+static npyflint_stats_entry* npyflint_stats_casts = NULL;
+/// @brief The histogram of the widths of the ufunc results
+static npy_int64 npyflint_stats_widths[NPYFLINT_STATS_BINS];
+
+/// @brief The wall clock time in seconds
+static double npyflint_stats_now(void) {
+    struct timespec t;
+    timespec_get(&t, TIME_UTC);
+    return t.tv_sec + 1e-9*t.tv_nsec;
+}
+
+/// @brief Add a call to a counter
+/// @param list The list that the counter is added to on its first call
+/// @param s The counter
+/// @param n The number of elements
+/// @param seconds The time of the call
+static void npyflint_stats_add(npyflint_stats_entry** list, npyflint_stats_entry* s,
+                               npy_intp n, double seconds) {
+    PyThread_acquire_lock(npyflint_stats_lock, WAIT_LOCK);
+    if (!s->used) {
+        s->used = 1;
+        s->next = *list;
+        *list = s;
+    }
+    s->calls++;
+    s->elements += n;
+    s->seconds += seconds;
+    PyThread_release_lock(npyflint_stats_lock);
+}
+
+/// @brief Get the histogram bin of a width
+static int npyflint_stats_bin(double eps) {
+    int e;
+    if (eps == 0.0) {
+        return 0;
+    }
+    if (!isfinite(eps)) {
+        return NPYFLINT_STATS_BINS-1;
+    }
+    frexp(eps, &e);
+    return e + 1074;
+}
+
+/// @brief Add the widths of a strided array of flints or flint32s to the histogram
+/// @param ptr The pointer to the first element
+/// @param std The stride of the array
+/// @param n The number of elements
+/// @param is32 True if the elements are flint32s
+static void npyflint_stats_add_widths(const char* ptr, npy_intp std, npy_intp n,
+                                      int is32) {
+    npy_intp i;
+    double eps;
+    PyThread_acquire_lock(npyflint_stats_lock, WAIT_LOCK);
+    for (i=0; i<n; i++) {
+        if (is32) {
+            eps = (double) ((const flint32*) ptr)->b - ((const flint32*) ptr)->a;
+        } else {
+            eps = ((const flint*) ptr)->b - ((const flint*) ptr)->a;
+        }
+        npyflint_stats_widths[npyflint_stats_bin(eps)]++;
+        ptr += std;
+    }
+    PyThread_release_lock(npyflint_stats_lock);
+}
+
+/// @brief Count a call to a cast function
+/// @param name The name of the cast as a string literal
+/// @param n The number of elements
+#define NPYFLINT_STATS_CAST(name, n) \
+    static npyflint_stats_entry _stats = {name}; \
+    if (npyflint_stats_enabled) { \
+        npyflint_stats_add(&npyflint_stats_casts, &_stats, n, 0.0); \
+    }
+
 // --------------------------------
 // ---- dtype to dtype casting ----
 // --------------------------------
@@ -1090,6 +1866,7 @@ static void npycast_##type##_flint(void* from, void* to, npy_intp n, \
     type* _from = (type*) from; \
     flint* _to = (flint*) to; \
     npy_intp i = 0; \
+    NPYFLINT_STATS_CAST(#type "->flint", n) \
     for (i=0; i<n; i++) { \
         _to[i] = double_to_flint(((double) _from[i])); \
     } \
@@ -1102,6 +1879,7 @@ static void npycast_##ctype##_flint(void* from, void* to, npy_intp n, \
     ctype* _from = (ctype*) from; \
     flint* _to = (flint*) to; \
     npy_intp i = 0; \
+    NPYFLINT_STATS_CAST(#ctype "->flint", n) \
     for (i=0; i<n; i++) { \
         _to[i] = double_to_flint(((double) _from[i].real)); \
     } \
@@ -1126,6 +1904,7 @@ SCALAR_TO_FLINT(NPY_ULONGLONG, npy_ulonglong)
 //     npy_half h = 0.0;
 //     flint f = {0.0, 0.0, 0.0};
 //     npy_intp i = 0;
+//     NPYFLINT_STATS_CAST("npy_half->flint", n)
 //     for (i=0; i<n; i++) {
 //         h = _from[i];
 //         f.a = npy_half_to_double(npy_half_nextafter(h, NPY_HALF_NINF));
@@ -1139,6 +1918,7 @@ static void npycast_npy_float_flint(void* from, void* to, npy_intp n,
     npy_float* _from = (npy_float*) from;
     flint* _to = (flint*) to;
     npy_intp i = 0;
+    NPYFLINT_STATS_CAST("npy_float->flint", n)
     for (i=0; i<n; i++) {
         _to[i] = float_to_flint(_from[i]);
     }
@@ -1151,6 +1931,7 @@ static void npycast_npy_cfloat_flint(void* from, void* to, npy_intp n,
     npy_cfloat* _from = (npy_cfloat*) from;
     flint* _to = (flint*) to;
     npy_intp i = 0;
+    NPYFLINT_STATS_CAST("npy_cfloat->flint", n)
     for (i=0; i<n; i++) {
         _to[i] = float_to_flint(_from[i].real);
     }
@@ -1158,23 +1939,47 @@ static void npycast_npy_cfloat_flint(void* from, void* to, npy_intp n,
 COMPLEX_TO_FLINT(NPY_CDOUBLE, npy_cdouble)
 COMPLEX_TO_FLINT(NPY_CLONGDOUBLE, npy_clongdouble)
 // ,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,
-// ---- dtype to flint casting ----
+// ---- flint to dtype casting ----
 // ````````````````````````````````
-// This section use's the v value and then the pre-defined numpy rules to for
-// doubles
+// This section uses the tracked value v, converted with the same c casts that NumPy
+// uses for doubles. NumPy hands the cast functions contiguous aligned runs, so each
+// one is a single pass that gathers v from every flint.
+/// @brief A macro to define conversions from flint to a real scalar type
 #define FLINT_TO_TYPE(npy_type_num, type) \
 static void npycast_flint_##type(void* src, void* dst, npy_intp n, \
                                  void* srcarr, void* dstarr) { \
-    PyArray_Descr* descr = PyArray_DescrFromType(NPY_DOUBLE); \
-    flint* _src = (flint*) src; \
+    const flint* _src = (const flint*) src; \
     type* _dst = (type*) dst; \
     npy_intp i = 0; \
+    NPYFLINT_STATS_CAST("flint->" #type, n) \
+    for (i=0; i<n; i++) { \
+        _dst[i] = (type) _src[i].v; \
+    } \
+}
+/// @brief A macro to define conversions from flint to a complex scalar type
+#define FLINT_TO_COMPLEX(npy_type_num, ctype, type) \
+static void npycast_flint_##ctype(void* src, void* dst, npy_intp n, \
+                                  void* srcarr, void* dstarr) { \
+    const flint* _src = (const flint*) src; \
+    ctype* _dst = (ctype*) dst; \
+    npy_intp i = 0; \
+    NPYFLINT_STATS_CAST("flint->" #ctype, n) \
     for (i=0; i<n; i++) { \
-        descr->f->cast[npy_type_num](&(_src[i].v), &(_dst[i]), n, NULL, NULL); \
+        _dst[i].real = (type) _src[i].v; \
+        _dst[i].imag = 0; \
     } \
-    Py_DECREF(descr); \
 }
-FLINT_TO_TYPE(NPY_BOOL, npy_bool)
+// The bool cast is true for any non-zero value, like for doubles
+static void npycast_flint_npy_bool(void* src, void* dst, npy_intp n,
+                                   void* srcarr, void* dstarr) {
+    const flint* _src = (const flint*) src;
+    npy_bool* _dst = (npy_bool*) dst;
+    npy_intp i = 0;
+    NPYFLINT_STATS_CAST("flint->npy_bool", n)
+    for (i=0; i<n; i++) {
+        _dst[i] = (_src[i].v != 0.0);
+    }
+}
 FLINT_TO_TYPE(NPY_BYTE, npy_byte)
 FLINT_TO_TYPE(NPY_SHORT, npy_short)
 FLINT_TO_TYPE(NPY_INT, npy_int)
@@ -1189,9 +1994,13 @@ FLINT_TO_TYPE(NPY_ULONGLONG, npy_ulonglong)
 FLINT_TO_TYPE(NPY_FLOAT, npy_float)
 FLINT_TO_TYPE(NPY_DOUBLE, npy_double)
 FLINT_TO_TYPE(NPY_LONGDOUBLE, npy_longdouble)
-FLINT_TO_TYPE(NPY_CFLOAT, npy_cfloat)
-FLINT_TO_TYPE(NPY_CDOUBLE, npy_cdouble)
-FLINT_TO_TYPE(NPY_CLONGDOUBLE, npy_clongdouble)
+FLINT_TO_COMPLEX(NPY_CFLOAT, npy_cfloat, npy_float)
+FLINT_TO_COMPLEX(NPY_CDOUBLE, npy_cdouble, npy_double)
+FLINT_TO_COMPLEX(NPY_CLONGDOUBLE, npy_clongdouble, npy_longdouble)
+
+/// @brief The signature of the serial ufunc loops
+typedef void npyflint_loop_func(char** args, const npy_intp* dim,
+                                const npy_intp* std, void* data);
 
 /// @brief Macro to define the internal loop for a universal function
 /// @param name The name of the function in c, Python and now NumPy
@@ -1230,60 +2039,2255 @@ static void npyflint_ufunc_##name(char** args, const npy_intp* dim, \
     npy_intp out_std = std[2]; \
     npy_intp n = dim[0]; \
     npy_intp i = 0; \
-    in0_type in0_f = {0.0, 0.0, 0.0}; \
-    in1_type in1_f = {0.0, 0.0, 0.0}; \
+    in0_type in0_f; \
+    in1_type in1_f; \
+    for (i=0; i<n; i++) { \
+        in0_f = *((in0_type*) in0_ptr); \
+        in1_f = *((in1_type*) in1_ptr); \
+        *((out_type*) out_ptr) = flint_##name(in0_f, in1_f); \
+        in0_ptr += in0_std; \
+        in1_ptr += in1_std; \
+        out_ptr += out_std; \
+    } \
+}
+
+/// @brief The shortest loop that is handed to the vector kernels
+#define NPYFLINT_SIMD_MIN 16
+
+/// @brief Check if a strided input overlaps the output other than element for element
+/// Accumulations read each output as the next input, those loops have to run one
+/// element at a time in order.
+/// @param in The first input element
+/// @param in_std The stride of the input in bytes
+/// @param out The first output element
+/// @param out_std The stride of the output in bytes
+/// @param n The number of elements
+/// @param size The size of an element in bytes
+/// @return 1 if the bytes touched overlap, and the input is not the output itself
+static int npyflint_overlaps(const char* in, npy_intp in_std, const char* out,
+                             npy_intp out_std, npy_intp n, npy_intp size) {
+    const char *in_lo = in, *in_hi = in, *out_lo = out, *out_hi = out;
+    if (n <= 0 || (in == out && in_std == out_std)) {
+        return 0;
+    }
+    if (in_std < 0) { in_lo += (n-1)*in_std; } else { in_hi += (n-1)*in_std; }
+    if (out_std < 0) { out_lo += (n-1)*out_std; } else { out_hi += (n-1)*out_std; }
+    return in_lo < out_hi + size && out_lo < in_hi + size;
+}
+
+/// @brief Macro to define the internal loop for a unary ufunc with a vector kernel
+/// @param name The name of the function in c, Python and now NumPy
+/// @param out_type the data type returned by the c function
+///
+/// Short loops and loops where the input overlaps the output are evaluated one element
+/// at a time with the scalar function.
+#define NPYFLINT_SIMD_UNARY_UFUNC(name, out_type) \
+static void npyflint_ufunc_##name(char** args, const npy_intp* dim, \
+                                  const npy_intp* std, void* data) { \
+    npy_intp i = 0; \
+    if (dim[0] >= NPYFLINT_SIMD_MIN && \
+        !npyflint_overlaps(args[0], std[0], args[1], std[1], dim[0], sizeof(flint))) { \
+        npyflint_simd->name(args[0], std[0], args[1], std[1], dim[0]); \
+        return; \
+    } \
+    for (i=0; i<dim[0]; i++) { \
+        *((out_type*) (args[1] + i*std[1])) = \
+            flint_##name(*((flint*) (args[0] + i*std[0]))); \
+    } \
+}
+
+/// @brief Macro to define the internal loop for a binary ufunc with a vector kernel
+/// @param name The name of the function in c, Python and now NumPy
+/// @param out_type the data type returned by the c function
+///
+/// Short loops, reductions, where the output has a zero stride and is fed back in as
+/// the first input, and accumulations, where each output is the next first input, are
+/// evaluated one element at a time with the scalar function.
+#define NPYFLINT_SIMD_BINARY_UFUNC(name, out_type) \
+static void npyflint_ufunc_##name(char** args, const npy_intp* dim, \
+                                  const npy_intp* std, void* data) { \
+    npy_intp i = 0; \
+    if (dim[0] >= NPYFLINT_SIMD_MIN && std[2] != 0 && \
+        !npyflint_overlaps(args[0], std[0], args[2], std[2], dim[0], sizeof(flint)) && \
+        !npyflint_overlaps(args[1], std[1], args[2], std[2], dim[0], sizeof(flint))) { \
+        npyflint_simd->name(args[0], std[0], args[1], std[1], \
+                            args[2], std[2], dim[0]); \
+        return; \
+    } \
+    for (i=0; i<dim[0]; i++) { \
+        *((out_type*) (args[2] + i*std[2])) = \
+            flint_##name(*((flint*) (args[0] + i*std[0])), \
+                         *((flint*) (args[1] + i*std[1]))); \
+    } \
+}
+
+#ifdef FLINT_DIRECTED_ROUNDING
+/// @brief The number of elements evaluated between switches of the rounding mode
+#define NPYFLINT_ROUNDING_BLOCK 256
+
+/// @brief Macro to define the internal loop for the directed rounding arithmetic
+/// @param name The name of the function in c, Python and now NumPy
+/// @param op The c operator to evaluate the tracked value
+///
+/// The loop works in blocks: first the boundaries for a block are all computed with
+/// the rounding mode set upward, then the tracked values for the same block are
+/// computed after the rounding mode has been restored. That way the rounding mode is
+/// only switched twice per block instead of twice per element.
+#define NPYFLINT_ROUNDED_UFUNC(name, op) \
+static void npyflint_ufunc_##name(char** args, const npy_intp* dim, \
+                                  const npy_intp* std, void* data) { \
+    char* in0_ptr = args[0]; \
+    char* in1_ptr = args[1]; \
+    char* out_ptr = args[2]; \
+    npy_intp in0_std = std[0]; \
+    npy_intp in1_std = std[1]; \
+    npy_intp out_std = std[2]; \
+    npy_intp n = dim[0]; \
+    npy_intp i = 0, j = 0, m = 0; \
+    int mode = 0; \
+    for (i=0; i<n; i+=m) { \
+        m = (n-i < NPYFLINT_ROUNDING_BLOCK) ? (n-i) : NPYFLINT_ROUNDING_BLOCK; \
+        mode = flint_round_upward(); \
+        for (j=0; j<m; j++) { \
+            flint_##name##_ru(*((flint*) (in0_ptr + j*in0_std)), \
+                              *((flint*) (in1_ptr + j*in1_std)), \
+                              (flint*) (out_ptr + j*out_std)); \
+        } \
+        flint_round_restore(mode); \
+        for (j=0; j<m; j++) { \
+            ((flint*) (out_ptr + j*out_std))->v = \
+                ((flint*) (in0_ptr + j*in0_std))->v op \
+                ((flint*) (in1_ptr + j*in1_std))->v; \
+        } \
+        in0_ptr += m*in0_std; \
+        in1_ptr += m*in1_std; \
+        out_ptr += m*out_std; \
+    } \
+}
+#endif
+
+// Arithmetic
+NPYFLINT_SIMD_UNARY_UFUNC(negative, flint)
+NPYFLINT_UNARY_UFUNC(positive, flint)
+#ifdef FLINT_DIRECTED_ROUNDING
+NPYFLINT_ROUNDED_UFUNC(add, +)
+NPYFLINT_ROUNDED_UFUNC(subtract, -)
+NPYFLINT_ROUNDED_UFUNC(multiply, *)
+NPYFLINT_ROUNDED_UFUNC(divide, /)
+#else
+NPYFLINT_SIMD_BINARY_UFUNC(add, flint)
+NPYFLINT_SIMD_BINARY_UFUNC(subtract, flint)
+NPYFLINT_SIMD_BINARY_UFUNC(multiply, flint)
+NPYFLINT_SIMD_BINARY_UFUNC(divide, flint)
+#endif
+NPYFLINT_BINARY_UFUNC(power, flint, flint, flint)
+NPYFLINT_BINARY_UFUNC(power_int, flint, npy_int64, flint)
+NPYFLINT_UNARY_UFUNC(square, flint)
+NPYFLINT_SIMD_BINARY_UFUNC(minimum, flint)
+NPYFLINT_SIMD_BINARY_UFUNC(maximum, flint)
+NPYFLINT_SIMD_BINARY_UFUNC(fmin, flint)
+NPYFLINT_SIMD_BINARY_UFUNC(fmax, flint)
+
+/// @brief The internal loop for the fused multiply-add x*y + z
+/// With directed rounding the boundaries are computed in blocks with the rounding mode
+/// set upward, like the other arithmetic loops.
+static void npyflint_ufunc_fma(char** args, const npy_intp* dim,
+                               const npy_intp* std, void* data) {
+    npy_intp n = dim[0];
+    npy_intp i = 0;
+#ifdef FLINT_DIRECTED_ROUNDING
+    npy_intp j = 0, m = 0;
+    int mode = 0;
+    const flint *x, *y, *z;
+    for (i=0; i<n; i+=m) {
+        m = (n-i < NPYFLINT_ROUNDING_BLOCK) ? (n-i) : NPYFLINT_ROUNDING_BLOCK;
+        mode = flint_round_upward();
+        for (j=i; j<i+m; j++) {
+            flint_fma_ru(*((flint*) (args[0] + j*std[0])),
+                         *((flint*) (args[1] + j*std[1])),
+                         *((flint*) (args[2] + j*std[2])),
+                         (flint*) (args[3] + j*std[3]));
+        }
+        flint_round_restore(mode);
+        for (j=i; j<i+m; j++) {
+            x = (const flint*) (args[0] + j*std[0]);
+            y = (const flint*) (args[1] + j*std[1]);
+            z = (const flint*) (args[2] + j*std[2]);
+            ((flint*) (args[3] + j*std[3]))->v = fma(x->v, y->v, z->v);
+        }
+    }
+#else
+    if (n >= NPYFLINT_SIMD_MIN &&
+        !npyflint_overlaps(args[0], std[0], args[3], std[3], n, sizeof(flint)) &&
+        !npyflint_overlaps(args[1], std[1], args[3], std[3], n, sizeof(flint)) &&
+        !npyflint_overlaps(args[2], std[2], args[3], std[3], n, sizeof(flint))) {
+        npyflint_simd->madd(args[0], std[0], args[1], std[1], args[2], std[2],
+                            args[3], std[3], n);
+        return;
+    }
+    for (i=0; i<n; i++) {
+        *((flint*) (args[3] + i*std[3])) =
+            flint_fma(*((flint*) (args[0] + i*std[0])),
+                      *((flint*) (args[1] + i*std[1])),
+                      *((flint*) (args[2] + i*std[2])));
+    }
+#endif
+}
+// Comparisons
+NPYFLINT_SIMD_BINARY_UFUNC(eq, npy_bool)
+NPYFLINT_SIMD_BINARY_UFUNC(ne, npy_bool)
+NPYFLINT_SIMD_BINARY_UFUNC(lt, npy_bool)
+NPYFLINT_SIMD_BINARY_UFUNC(le, npy_bool)
+NPYFLINT_SIMD_BINARY_UFUNC(gt, npy_bool)
+NPYFLINT_SIMD_BINARY_UFUNC(ge, npy_bool)
+
+/// @brief The number of doubles converted to flints at a time by the mixed loops
+#define NPYFLINT_MIXED_BLOCK 128
+
+/// @brief Run a flint, flint loop with one of the inputs given as doubles
+/// @param loop The serial flint, flint ufunc loop
+/// @param pos The index of the double input, 0 or 1
+///
+/// A broadcast double is turned into a flint once and the loop is run with a zero
+/// stride. Otherwise the doubles are turned into flints a block at a time in a buffer
+/// on the stack, so there is never a temporary flint array the size of the input.
+static void npyflint_mixed_loop(npyflint_loop_func* loop, int pos, char** args,
+                                const npy_intp* dim, const npy_intp* std, void* data) {
+    flint buf[NPYFLINT_MIXED_BLOCK];
+    char* f_args[3];
+    npy_intp f_std[3];
+    npy_intp n = dim[0];
+    npy_intp i = 0, j = 0, m = 0;
+    double d;
+    int k;
+    for (k=0; k<3; k++) {
+        f_args[k] = args[k];
+        f_std[k] = std[k];
+    }
+    f_args[pos] = (char*) buf;
+    if (std[pos] == 0) {
+        if (n > 0) {
+            buf[0] = double_to_flint(*((double*) args[pos]));
+            loop(f_args, dim, f_std, data);
+        }
+        return;
+    }
+    f_std[pos] = sizeof(flint);
+    for (i=0; i<n; i+=m) {
+        m = (n-i < NPYFLINT_MIXED_BLOCK) ? (n-i) : NPYFLINT_MIXED_BLOCK;
+        for (j=0; j<m; j++) {
+            d = *((double*) (args[pos] + (i+j)*std[pos]));
+            // The same as double_to_flint, but without the calls to nextafter
+            buf[j].a = flint_nextdown(d);
+            buf[j].b = flint_nextup(d);
+            buf[j].v = d;
+        }
+        f_args[1-pos] = args[1-pos] + i*std[1-pos];
+        f_args[2] = args[2] + i*std[2];
+        loop(f_args, &m, f_std, data);
+    }
+}
+
+/// @brief Macro to define the internal loops for a ufunc with a flint and a double
+/// @param name The name of the flint, flint loop
+///
+/// This defines the loops `npyflint_ufunc_NAME_mixed` for (flint, double) and
+/// `npyflint_ufunc_mixed_NAME` for (double, flint), so NumPy does not have to cast
+/// the doubles into a temporary flint array first.
+#define NPYFLINT_MIXED_UFUNC(name) \
+static void npyflint_ufunc_##name##_mixed(char** args, const npy_intp* dim, \
+                                          const npy_intp* std, void* data) { \
+    npyflint_mixed_loop(npyflint_ufunc_##name, 1, args, dim, std, data); \
+} \
+static void npyflint_ufunc_mixed_##name(char** args, const npy_intp* dim, \
+                                        const npy_intp* std, void* data) { \
+    npyflint_mixed_loop(npyflint_ufunc_##name, 0, args, dim, std, data); \
+}
+
+NPYFLINT_MIXED_UFUNC(add)
+NPYFLINT_MIXED_UFUNC(subtract)
+NPYFLINT_MIXED_UFUNC(multiply)
+NPYFLINT_MIXED_UFUNC(divide)
+NPYFLINT_MIXED_UFUNC(eq)
+NPYFLINT_MIXED_UFUNC(ne)
+NPYFLINT_MIXED_UFUNC(lt)
+NPYFLINT_MIXED_UFUNC(le)
+NPYFLINT_MIXED_UFUNC(gt)
+NPYFLINT_MIXED_UFUNC(ge)
+// elementary functions
+NPYFLINT_UNARY_UFUNC(isnan, npy_bool)
+NPYFLINT_UNARY_UFUNC(isinf, npy_bool)
+NPYFLINT_UNARY_UFUNC(isfinite, npy_bool)
+NPYFLINT_SIMD_UNARY_UFUNC(absolute, flint)
+NPYFLINT_SIMD_UNARY_UFUNC(sqrt, flint)
+NPYFLINT_UNARY_UFUNC(cbrt, flint)
+NPYFLINT_BINARY_UFUNC(hypot, flint, flint, flint)
+NPYFLINT_UNARY_UFUNC(exp, flint)
+NPYFLINT_UNARY_UFUNC(exp2, flint)
+NPYFLINT_UNARY_UFUNC(expm1, flint)
+NPYFLINT_UNARY_UFUNC(log, flint)
+NPYFLINT_UNARY_UFUNC(log10, flint)
+NPYFLINT_UNARY_UFUNC(log2, flint)
+NPYFLINT_UNARY_UFUNC(log1p, flint)
+NPYFLINT_UNARY_UFUNC(sin, flint)
+NPYFLINT_UNARY_UFUNC(cos, flint)
+NPYFLINT_UNARY_UFUNC(tan, flint)
+NPYFLINT_UNARY_UFUNC(asin, flint)
+NPYFLINT_UNARY_UFUNC(acos, flint)
+NPYFLINT_UNARY_UFUNC(atan, flint)
+NPYFLINT_BINARY_UFUNC(atan2, flint, flint, flint)
+NPYFLINT_UNARY_UFUNC(sinh, flint)
+NPYFLINT_UNARY_UFUNC(cosh, flint)
+NPYFLINT_UNARY_UFUNC(tanh, flint)
+NPYFLINT_UNARY_UFUNC(asinh, flint)
+NPYFLINT_UNARY_UFUNC(acosh, flint)
+NPYFLINT_UNARY_UFUNC(atanh, flint)
+// rounding and remainders
+NPYFLINT_SIMD_UNARY_UFUNC(floor, flint)
+NPYFLINT_SIMD_UNARY_UFUNC(ceil, flint)
+NPYFLINT_SIMD_UNARY_UFUNC(trunc, flint)
+NPYFLINT_SIMD_UNARY_UFUNC(rint, flint)
+NPYFLINT_BINARY_UFUNC(fmod, flint, flint, flint)
+NPYFLINT_BINARY_UFUNC(remainder, flint, flint, flint)
+NPYFLINT_BINARY_UFUNC(floor_divide, flint, flint, flint)
+
+/// @brief The internal loop for modf, with the fractional and integer parts as outputs
+static void npyflint_ufunc_modf(char** args, const npy_intp* dim,
+                                const npy_intp* std, void* data) {
+    char* in_ptr = args[0];
+    char* frac_ptr = args[1];
+    char* int_ptr = args[2];
+    npy_intp in_std = std[0];
+    npy_intp frac_std = std[1];
+    npy_intp int_std = std[2];
+    npy_intp n = dim[0];
+    npy_intp i = 0;
+    for (i=0; i<n; i++) {
+        *((flint*) frac_ptr) = flint_modf(*((flint*) in_ptr), (flint*) int_ptr);
+        in_ptr += in_std;
+        frac_ptr += frac_std;
+        int_ptr += int_std;
+    }
+}
+
+// ,,,,,,,,,,,,,,,,,,,,,,,,
+// ---- reduction loops ----
+// ````````````````````````
+// NumPy runs a reduction like `np.sum` through the binary loop with the output
+// aliased to the first input and both of their strides set to zero, making every step
+// depend on the one before. The reduce loops below instead add (or multiply, ...) a
+// block of the input into a row of independent accumulators with the ordinary serial
+// loop, so the vector kernels do the work. The accumulators are then combined
+// pairwise, and long inputs are split in half recursively. Every step is still a
+// rounded flint operation, so the result encloses the exact reduction, and the
+// partial sums stay smaller which keeps the interval tighter.
+
+/// @brief The number of independent accumulators
+#define NPYFLINT_REDUCE_LANES 128
+/// @brief Inputs longer than this are split in half and reduced recursively
+#define NPYFLINT_PAIRWISE_BLOCK 8192
+
+/// @brief Reduce a strided run of flints with a serial binary loop
+/// @param loop The serial ufunc loop for the binary operation
+/// @param in_ptr A pointer to the first flint
+/// @param in_std The stride between flints in bytes
+/// @param n The number of flints, at least one
+/// @return The reduction of all n flints
+static flint npyflint_pairwise(npyflint_loop_func* loop, char* in_ptr, npy_intp in_std,
+                               npy_intp n) {
+    flint acc[NPYFLINT_REDUCE_LANES];
+    char* args[3];
+    npy_intp std[3];
+    npy_intp i, m;
+    flint left, right;
+    if (n > NPYFLINT_PAIRWISE_BLOCK) {
+        m = n/2/NPYFLINT_REDUCE_LANES*NPYFLINT_REDUCE_LANES;
+        left = npyflint_pairwise(loop, in_ptr, in_std, m);
+        right = npyflint_pairwise(loop, in_ptr + m*in_std, in_std, n - m);
+        m = 1;
+        args[0] = (char*) &left; args[1] = (char*) &right; args[2] = (char*) &left;
+        std[0] = 0; std[1] = 0; std[2] = 0;
+        loop(args, &m, std, NULL);
+        return left;
+    }
+    if (n < 2*NPYFLINT_REDUCE_LANES) {
+        acc[0] = *((flint*) in_ptr);
+        i = 1;
+    } else {
+        // Fill the accumulators with the first block, then add in the other blocks
+        for (i=0; i<NPYFLINT_REDUCE_LANES; i++) {
+            acc[i] = *((flint*) (in_ptr + i*in_std));
+        }
+        m = NPYFLINT_REDUCE_LANES;
+        args[0] = (char*) acc; args[2] = (char*) acc;
+        std[0] = sizeof(flint); std[1] = in_std; std[2] = sizeof(flint);
+        for (; i+NPYFLINT_REDUCE_LANES <= n; i+=NPYFLINT_REDUCE_LANES) {
+            args[1] = in_ptr + i*in_std;
+            loop(args, &m, std, NULL);
+        }
+        // Combine the accumulators pairwise
+        std[1] = sizeof(flint);
+        for (m=NPYFLINT_REDUCE_LANES/2; m>0; m/=2) {
+            args[1] = (char*) (acc + m);
+            loop(args, &m, std, NULL);
+        }
+    }
+    // Reduce the leftover elements into the first accumulator
+    if (i < n) {
+        m = n - i;
+        args[0] = (char*) acc; args[1] = in_ptr + i*in_std; args[2] = (char*) acc;
+        std[0] = 0; std[1] = in_std; std[2] = 0;
+        loop(args, &m, std, NULL);
+    }
+    return acc[0];
+}
+
+/// @brief Macro to define the reduce loop for a binary flint ufunc
+/// @param name The name of the serial loop
+#define NPYFLINT_REDUCE_UFUNC(name) \
+static void npyflint_reduce_##name(char** args, const npy_intp* dim, \
+                                   const npy_intp* std, void* data) { \
+    flint res; \
+    char* red_args[3]; \
+    npy_intp red_std[3] = {0, 0, 0}; \
+    npy_intp one = 1; \
+    if (dim[0] < 2*NPYFLINT_REDUCE_LANES) { \
+        npyflint_ufunc_##name(args, dim, std, data); \
+        return; \
+    } \
+    res = npyflint_pairwise(npyflint_ufunc_##name, args[1], std[1], dim[0]); \
+    red_args[0] = args[0]; \
+    red_args[1] = (char*) &res; \
+    red_args[2] = args[0]; \
+    npyflint_ufunc_##name(red_args, &one, red_std, data); \
+}
+
+NPYFLINT_REDUCE_UFUNC(add)
+NPYFLINT_REDUCE_UFUNC(multiply)
+NPYFLINT_REDUCE_UFUNC(minimum)
+NPYFLINT_REDUCE_UFUNC(maximum)
+NPYFLINT_REDUCE_UFUNC(fmin)
+NPYFLINT_REDUCE_UFUNC(fmax)
+
+// ,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,
+// ---- parallel ufunc loops ----
+// ``````````````````````````````
+// Every ufunc loop is registered through npyflint_ufunc_parallel, which splits long
+// inner loops across a persistent pool of worker threads. The pool only uses the
+// PyThread locks and threads from the python c api, so it runs wherever python does.
+// The calling thread always does its share of the work, so a pool with n threads has
+// n-1 workers. The cheap loops are cut into one even chunk per thread. The cost of the
+// transcendental functions depends on the branch each element takes, so their threads
+// keep taking chunks from a shared counter until the loop is done.
+
+/// @brief The maximum number of threads used by a ufunc loop
+#define NPYFLINT_MAX_THREADS 256
+/// @brief The shortest loop that is split for the evenly chunked ufuncs
+#define NPYFLINT_STATIC_MIN 65536
+/// @brief The shortest loop that is split for the dynamically chunked ufuncs
+#define NPYFLINT_DYNAMIC_MIN 4096
+/// @brief The smallest chunk taken by the dynamically chunked ufuncs
+#define NPYFLINT_DYNAMIC_CHUNK 256
+/// @brief Chunk boundaries are a multiple of this, so two threads never write to the
+/// same cache line
+#define NPYFLINT_CHUNK_ALIGN 64
+#ifndef PYTHREAD_INVALID_THREAD_ID
+#define PYTHREAD_INVALID_THREAD_ID ((unsigned long)-1)
+#endif
+
+/// @brief How a loop is split between the threads
+enum npyflint_schedule {NPYFLINT_STATIC, NPYFLINT_DYNAMIC};
+/// @brief The type of the results of a loop, for the width histogram
+enum npyflint_out {NPYFLINT_OUT_BOOL, NPYFLINT_OUT_FLINT, NPYFLINT_OUT_FLINT32};
+
+/// @brief The serial loop and how to split it, passed to the parallel loop as the data
+typedef struct {
+    npyflint_loop_func* loop;
+    int nargs;
+    /// The number of outputs, which are the last arguments
+    int nout;
+    int schedule;
+    /// The reduce loop, or NULL if reductions just use the serial loop
+    npyflint_loop_func* reduce;
+    /// The type of the results
+    int out;
+    /// The performance counters of the loop
+    npyflint_stats_entry stats;
+} npyflint_parallel_info;
+
+/// @brief A ufunc loop that is being run by the pool
+typedef struct {
+    const npyflint_parallel_info* info;
+    char* args[4];
+    npy_intp std[4];
+    npy_intp n;
+    npy_intp chunk;
+    /// The start of the next dynamic chunk, guarded by the job lock
+    npy_intp next;
+    /// The floating point exceptions raised by the workers, guarded by the job lock
+    int fpe;
+    /// The data passed on to the serial loop
+    void* data;
+} npyflint_job;
+
+/// @brief A worker thread with the locks used to start it and wait for it
+typedef struct {
+    int id;
+    PyThread_type_lock start;
+    PyThread_type_lock done;
+} npyflint_worker;
+
+/// @brief The worker threads, the calling thread takes slot 0
+static npyflint_worker npyflint_workers[NPYFLINT_MAX_THREADS];
+/// @brief The number of worker threads that have been started
+static int npyflint_num_workers = 0;
+/// @brief The number of threads used by the ufunc loops, including the calling thread
+static int npyflint_num_threads = 1;
+/// @brief Held while a ufunc loop uses the pool or the pool is being resized
+static PyThread_type_lock npyflint_pool_lock = NULL;
+/// @brief Guards the shared parts of the running job
+static PyThread_type_lock npyflint_job_lock = NULL;
+/// @brief The job that the workers run when they are started
+static npyflint_job* npyflint_current_job = NULL;
+
+/// @brief Run the serial loop over a part of the job
+static void npyflint_run_chunk(npyflint_job* job, npy_intp start, npy_intp count) {
+    char* args[4];
+    int i;
+    for (i=0; i<job->info->nargs; i++) {
+        args[i] = job->args[i] + start*job->std[i];
+    }
+    job->info->loop(args, &count, job->std, job->data);
+}
+
+/// @brief Run one thread's share of the job
+/// @param id The index of the thread, 0 for the calling thread
+static void npyflint_run_job(npyflint_job* job, int id) {
+    npy_intp start;
+    if (job->info->schedule == NPYFLINT_STATIC) {
+        start = id*job->chunk;
+        if (start < job->n) {
+            npyflint_run_chunk(job, start, (job->n - start < job->chunk) ? job->n - start : job->chunk);
+        }
+        return;
+    }
+    for (;;) {
+        PyThread_acquire_lock(npyflint_job_lock, WAIT_LOCK);
+        start = job->next;
+        job->next += job->chunk;
+        PyThread_release_lock(npyflint_job_lock);
+        if (start >= job->n) {
+            return;
+        }
+        npyflint_run_chunk(job, start, (job->n - start < job->chunk) ? job->n - start : job->chunk);
+    }
+}
+
+/// @brief The main function of the worker threads
+/// The workers wait on their start lock, run their share of the current job, collect
+/// the floating point exceptions it raised, then release their done lock.
+static void npyflint_worker_main(void* arg) {
+    npyflint_worker* w = (npyflint_worker*) arg;
+    int fpe;
+    for (;;) {
+        PyThread_acquire_lock(w->start, WAIT_LOCK);
+        feclearexcept(FE_ALL_EXCEPT);
+        npyflint_run_job(npyflint_current_job, w->id);
+        fpe = fetestexcept(FE_ALL_EXCEPT);
+        if (fpe) {
+            PyThread_acquire_lock(npyflint_job_lock, WAIT_LOCK);
+            npyflint_current_job->fpe |= fpe;
+            PyThread_release_lock(npyflint_job_lock);
+        }
+        PyThread_release_lock(w->done);
+    }
+}
+
+/// @brief Set the number of threads used by the ufunc loops, starting new workers if
+/// needed. The GIL must be held.
+/// @return 0 on success, -1 if a worker could not be started
+static int npyflint_set_threads(int n) {
+    npyflint_worker* w;
+    int ret = 0;
+    Py_BEGIN_ALLOW_THREADS
+    PyThread_acquire_lock(npyflint_pool_lock, WAIT_LOCK);
+    while (npyflint_num_workers < n-1) {
+        w = &npyflint_workers[npyflint_num_workers+1];
+        w->id = npyflint_num_workers+1;
+        w->start = PyThread_allocate_lock();
+        w->done = PyThread_allocate_lock();
+        if (w->start == NULL || w->done == NULL) {
+            ret = -1;
+        } else {
+            // Both locks start out held, so the new worker waits for its first job
+            PyThread_acquire_lock(w->start, WAIT_LOCK);
+            PyThread_acquire_lock(w->done, WAIT_LOCK);
+            if (PyThread_start_new_thread(npyflint_worker_main, w) == PYTHREAD_INVALID_THREAD_ID) {
+                ret = -1;
+            }
+        }
+        if (ret < 0) {
+            if (w->start != NULL) {
+                PyThread_free_lock(w->start);
+            }
+            if (w->done != NULL) {
+                PyThread_free_lock(w->done);
+            }
+            break;
+        }
+        npyflint_num_workers++;
+    }
+    npyflint_num_threads = (n < npyflint_num_workers+1) ? n : npyflint_num_workers+1;
+    PyThread_release_lock(npyflint_pool_lock);
+    Py_END_ALLOW_THREADS
+    return ret;
+}
+
+/// @brief Run a job on the pool, with the calling thread doing the first share
+/// The pool lock must already be held, and is released once the job is done.
+/// @param job The job with everything but the shared counter and exceptions filled in
+/// @param nthreads The number of threads to use
+static void npyflint_pool_run(npyflint_job* job, int nthreads) {
+    int i;
+    job->next = 0;
+    job->fpe = 0;
+    npyflint_current_job = job;
+    for (i=1; i<nthreads; i++) {
+        PyThread_release_lock(npyflint_workers[i].start);
+    }
+    npyflint_run_job(job, 0);
+    for (i=1; i<nthreads; i++) {
+        PyThread_acquire_lock(npyflint_workers[i].done, WAIT_LOCK);
+    }
+    npyflint_current_job = NULL;
+    PyThread_release_lock(npyflint_pool_lock);
+    // NumPy checks the floating point exceptions of the calling thread after the loop
+    if (job->fpe) {
+        feraiseexcept(job->fpe);
+    }
+}
+
+/// @brief Check if any input of a loop overlaps one of its outputs at another element
+static int npyflint_loop_overlaps(char** args, const npy_intp* dim,
+                                  const npy_intp* std,
+                                  const npyflint_parallel_info* info) {
+    npy_intp size = (info->out == NPYFLINT_OUT_FLINT) ? sizeof(flint) :
+                    (info->out == NPYFLINT_OUT_FLINT32) ? sizeof(flint32) : 1;
+    int i, j;
+    for (i=0; i<info->nargs-info->nout; i++) {
+        for (j=info->nargs-info->nout; j<info->nargs; j++) {
+            if (npyflint_overlaps(args[i], std[i], args[j], std[j], dim[0], size)) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/// @brief Run a ufunc loop, split across the threads if it is long enough
+/// Reductions use the reduce loop if there is one. Short loops, the other reductions,
+/// accumulations, and loops started while the pool is busy with another call run the
+/// serial loop directly on the calling thread.
+static void npyflint_ufunc_dispatch(char** args, const npy_intp* dim,
+                                    const npy_intp* std,
+                                    const npyflint_parallel_info* info) {
+    npyflint_job job;
+    npy_intp n = dim[0];
+    npy_intp n_min;
+    int nthreads, i;
+    if (info->reduce != NULL && args[0] == args[2] && std[0] == 0 && std[2] == 0) {
+        info->reduce(args, dim, std, NULL);
+        return;
+    }
+    n_min = (info->schedule == NPYFLINT_STATIC) ? NPYFLINT_STATIC_MIN : NPYFLINT_DYNAMIC_MIN;
+    if (npyflint_num_threads < 2 || n < n_min || std[info->nargs-1] == 0 ||
+        npyflint_loop_overlaps(args, dim, std, info) ||
+        !PyThread_acquire_lock(npyflint_pool_lock, NOWAIT_LOCK)) {
+        info->loop(args, dim, std, NULL);
+        return;
+    }
+    nthreads = npyflint_num_threads;
+    job.info = info;
+    for (i=0; i<info->nargs; i++) {
+        job.args[i] = args[i];
+        job.std[i] = std[i];
+    }
+    job.n = n;
+    if (info->schedule == NPYFLINT_STATIC) {
+        job.chunk = (n + nthreads - 1)/nthreads;
+    } else {
+        // Guided chunks: big enough to keep the job lock quiet, small enough that every
+        // thread takes several of them
+        job.chunk = n/(8*nthreads);
+        if (job.chunk < NPYFLINT_DYNAMIC_CHUNK) {
+            job.chunk = NPYFLINT_DYNAMIC_CHUNK;
+        }
+    }
+    job.chunk = (job.chunk + NPYFLINT_CHUNK_ALIGN - 1)/NPYFLINT_CHUNK_ALIGN*NPYFLINT_CHUNK_ALIGN;
+    job.data = NULL;
+    npyflint_pool_run(&job, nthreads);
+}
+
+/// @brief The inner loop registered for every flint ufunc
+/// With the performance counters on, the loop is timed and the widths of its flint
+/// results are added to the histogram, a reduction only adds its final result.
+static void npyflint_ufunc_parallel(char** args, const npy_intp* dim,
+                                    const npy_intp* std, void* data) {
+    npyflint_parallel_info* info = (npyflint_parallel_info*) data;
+    int i;
+    double t0;
+    if (!npyflint_stats_enabled) {
+        npyflint_ufunc_dispatch(args, dim, std, info);
+        return;
+    }
+    t0 = npyflint_stats_now();
+    npyflint_ufunc_dispatch(args, dim, std, info);
+    npyflint_stats_add(&npyflint_stats_loops, &info->stats, dim[0], npyflint_stats_now() - t0);
+    if (info->out != NPYFLINT_OUT_BOOL) {
+        for (i=info->nargs-info->nout; i<info->nargs; i++) {
+            npyflint_stats_add_widths(args[i], std[i], (std[i] == 0) ? 1 : dim[0],
+                                      info->out == NPYFLINT_OUT_FLINT32);
+        }
+    }
+}
+
+/// @brief Macro to define how a ufunc loop is split across the threads
+/// @param name The name of the serial loop
+/// @param nargs The number of inputs and outputs of the loop
+/// @param schedule Either NPYFLINT_STATIC or NPYFLINT_DYNAMIC
+/// @param out The type of the results, one of the npyflint_out values
+#define NPYFLINT_PARALLEL(name, nargs, schedule, out) \
+static npyflint_parallel_info npyflint_parallel_##name = { \
+    npyflint_ufunc_##name, nargs, 1, schedule, NULL, out, {#name} \
+};
+
+/// @brief Macro to define how a ufunc loop with two outputs is split across the threads
+/// @param name The name of the serial loop
+/// @param schedule Either NPYFLINT_STATIC or NPYFLINT_DYNAMIC
+/// @param out The type of the results, one of the npyflint_out values
+#define NPYFLINT_PARALLEL_TWO_OUT(name, schedule, out) \
+static npyflint_parallel_info npyflint_parallel_##name = { \
+    npyflint_ufunc_##name, 3, 2, schedule, NULL, out, {#name} \
+};
+
+/// @brief Macro to define how a binary ufunc loop with a reduce loop is split
+/// @param name The name of the serial loop
+/// @param out The type of the results, one of the npyflint_out values
+#define NPYFLINT_PARALLEL_REDUCE(name, out) \
+static npyflint_parallel_info npyflint_parallel_##name = { \
+    npyflint_ufunc_##name, 3, 1, NPYFLINT_STATIC, npyflint_reduce_##name, out, {#name} \
+};
+
+// Arithmetic
+NPYFLINT_PARALLEL(negative, 2, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(positive, 2, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL_REDUCE(add, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(subtract, 3, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL_REDUCE(multiply, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(divide, 3, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(power, 3, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(power_int, 3, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(square, 2, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(fma, 4, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL_REDUCE(minimum, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL_REDUCE(maximum, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL_REDUCE(fmin, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL_REDUCE(fmax, NPYFLINT_OUT_FLINT)
+// Comparisons
+NPYFLINT_PARALLEL(eq, 3, NPYFLINT_STATIC, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL(ne, 3, NPYFLINT_STATIC, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL(lt, 3, NPYFLINT_STATIC, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL(le, 3, NPYFLINT_STATIC, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL(gt, 3, NPYFLINT_STATIC, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL(ge, 3, NPYFLINT_STATIC, NPYFLINT_OUT_BOOL)
+// Mixed flint and double
+#define NPYFLINT_PARALLEL_MIXED(name, out) \
+NPYFLINT_PARALLEL(name##_mixed, 3, NPYFLINT_STATIC, out) \
+NPYFLINT_PARALLEL(mixed_##name, 3, NPYFLINT_STATIC, out)
+NPYFLINT_PARALLEL_MIXED(add, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL_MIXED(subtract, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL_MIXED(multiply, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL_MIXED(divide, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL_MIXED(eq, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL_MIXED(ne, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL_MIXED(lt, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL_MIXED(le, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL_MIXED(gt, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL_MIXED(ge, NPYFLINT_OUT_BOOL)
+// elementary functions
+NPYFLINT_PARALLEL(isnan, 2, NPYFLINT_STATIC, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL(isinf, 2, NPYFLINT_STATIC, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL(isfinite, 2, NPYFLINT_STATIC, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL(absolute, 2, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(sqrt, 2, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(cbrt, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(hypot, 3, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(exp, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(exp2, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(expm1, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(log, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(log10, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(log2, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(log1p, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(sin, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(cos, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(tan, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(asin, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(acos, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(atan, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(atan2, 3, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(sinh, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(cosh, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(tanh, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(asinh, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(acosh, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(atanh, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+// rounding and remainders
+NPYFLINT_PARALLEL(floor, 2, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(ceil, 2, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(trunc, 2, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(rint, 2, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(fmod, 3, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(remainder, 3, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL(floor_divide, 3, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT)
+NPYFLINT_PARALLEL_TWO_OUT(modf, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT)
+
+// ,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,
+// ---- matrix multiplication ----
+// ```````````````````````````````
+// The matmul loop builds each row of C = A B as a sum of the rows of B scaled by the
+// elements in the same row of A, so the elements along a row of C are independent sums
+// that the vector kernels work on together. B is copied in panels of up to
+// NPYFLINT_MATMUL_KB rows and NPYFLINT_MATMUL_NB columns into separate arrays of lower
+// bounds, upper bounds, and tracked values, that stay in the cache while every row of A
+// uses them. Each element of C starts with the first product and adds up the rest in
+// order with fused multiply-adds. Large products are split across the thread pool by rows.
+// Products with only a few columns, like matrix vector products, go through the same
+// kernels padded out to a group of lanes, so every product sums in the same order.
+
+/// @brief The number of columns of B in a panel
+#define NPYFLINT_MATMUL_NB 128
+/// @brief The number of rows of B in a panel
+#define NPYFLINT_MATMUL_KB 64
+/// @brief The smallest number of multiply-adds in a product split across the threads
+#define NPYFLINT_MATMUL_PARALLEL_MIN 262144
+
+/// @brief The shape and strides of a matrix product, passed to the row loop as data
+typedef struct {
+    /// The number of columns of A and rows of B
+    npy_intp n;
+    /// The number of columns of B and C
+    npy_intp p;
+    /// The strides along the rows of A, the columns of B, and the rows of C
+    npy_intp a_n, b_n, b_p, c_p;
+} npyflint_matmul_info;
+
+/// @brief Multiply the row of flints y by x into z, the arrays hold lower bounds, upper
+/// bounds, and tracked values of n flints
+static void npyflint_mul_row(flint x, const double* ya, const double* yb,
+                             const double* yv, double* za, double* zb, double* zv,
+                             npy_intp n) {
+#ifdef FLINT_DIRECTED_ROUNDING
+    npy_intp j = 0;
+    flint y, z;
+    int mode = flint_round_upward();
+    for (j=0; j<n; j++) {
+        y.a = ya[j];
+        y.b = yb[j];
+        flint_multiply_ru(x, y, &z);
+        za[j] = z.a;
+        zb[j] = z.b;
+    }
+    flint_round_restore(mode);
+    for (j=0; j<n; j++) {
+        zv[j] = x.v*yv[j];
+    }
+#else
+    npyflint_simd->mul_row(x, ya, yb, yv, za, zb, zv, n);
+#endif
+}
+
+/// @brief Multiply the row of flints y by x and add it to z, with fused multiply-adds
+///        if the vector kernels have them
+static void npyflint_madd_row(flint x, const double* ya, const double* yb,
+                              const double* yv, double* za, double* zb, double* zv,
+                              npy_intp n) {
+#ifdef FLINT_DIRECTED_ROUNDING
+    npy_intp j = 0;
+    flint y, z;
+    int mode = flint_round_upward();
+    for (j=0; j<n; j++) {
+        y.a = ya[j];
+        y.b = yb[j];
+        z.a = za[j];
+        z.b = zb[j];
+        flint_madd_ru(x, y, z, &z);
+        za[j] = z.a;
+        zb[j] = z.b;
+    }
+    flint_round_restore(mode);
+    for (j=0; j<n; j++) {
+#if FLINT_FAST_FMA
+        zv[j] = fma(x.v, yv[j], zv[j]);
+#else
+        zv[j] = zv[j] + x.v*yv[j];
+#endif
+    }
+#else
+    npyflint_simd->madd_row(x, ya, yb, yv, za, zb, zv, n);
+#endif
+}
+
+/// @brief Compute a block of rows of a matrix product C = A B
+/// @param args The first rows of A, B, and C
+/// @param dim The number of rows of A and C
+/// @param std The strides between the rows of A, (unused) B, and C
+/// @param data The npyflint_matmul_info with the rest of the shape and strides
+static void npyflint_matmul_rows(char** args, const npy_intp* dim,
+                                 const npy_intp* std, void* data) {
+    const npyflint_matmul_info* mi = (const npyflint_matmul_info*) data;
+    npy_intp m = dim[0];
+    npy_intp i = 0, j = 0, k = 0, j0 = 0, k0 = 0, nb = 0, kb = 0, nl = 0;
+    const char* a_row;
+    char* c_row;
+    const flint* f;
+    flint* g;
+    flint zero = {0.0, 0.0, 0.0};
+    double small[3*2*FLINT_SIMD_LANES];
+    double *buf = NULL, *ba, *bb, *bv, *ca, *cb, *cv;
+    // The panel sizes, a single group of lanes from a single row of B if the panel
+    // could not be allocated
+    npy_intp pn = NPYFLINT_MATMUL_NB, pk = NPYFLINT_MATMUL_KB;
+    // The empty sums
+    if (mi->n == 0) {
+        for (i=0; i<m; i++) {
+            for (j=0; j<mi->p; j++) {
+                *((flint*) (args[2] + i*std[2] + j*mi->c_p)) = zero;
+            }
+        }
+        return;
+    }
+    buf = (double*) malloc(3*(NPYFLINT_MATMUL_KB+1)*NPYFLINT_MATMUL_NB*sizeof(double));
+    ba = buf;
+    if (buf == NULL) {
+        pn = FLINT_SIMD_LANES;
+        pk = 1;
+        ba = small;
+    }
+    bb = ba + pk*pn;
+    bv = bb + pk*pn;
+    ca = bv + pk*pn;
+    cb = ca + pn;
+    cv = cb + pn;
+    for (j0=0; j0<mi->p; j0+=nb) {
+        nb = (mi->p - j0 < pn) ? mi->p - j0 : pn;
+        // The row kernels work on whole groups of lanes, the extra lanes repeat the
+        // last column
+        nl = (nb + FLINT_SIMD_LANES - 1)/FLINT_SIMD_LANES*FLINT_SIMD_LANES;
+        for (k0=0; k0<mi->n; k0+=kb) {
+            kb = (mi->n - k0 < pk) ? mi->n - k0 : pk;
+            // Copy the panel of B
+            for (k=0; k<kb; k++) {
+                for (j=0; j<nl; j++) {
+                    f = (const flint*) (args[1] + (k0+k)*mi->b_n +
+                                        (j0 + ((j < nb) ? j : nb-1))*mi->b_p);
+                    ba[k*pn+j] = f->a;
+                    bb[k*pn+j] = f->b;
+                    bv[k*pn+j] = f->v;
+                }
+            }
+            for (i=0; i<m; i++) {
+                a_row = args[0] + i*std[0] + k0*mi->a_n;
+                c_row = args[2] + i*std[2] + j0*mi->c_p;
+                k = 0;
+                // The sums start with the first product, otherwise pick up the partial
+                // sums from the previous panel
+                if (k0 == 0) {
+                    npyflint_mul_row(*((const flint*) a_row), ba, bb, bv, ca, cb, cv, nl);
+                    k = 1;
+                } else {
+                    for (j=0; j<nl; j++) {
+                        g = (flint*) (c_row + ((j < nb) ? j : nb-1)*mi->c_p);
+                        ca[j] = g->a;
+                        cb[j] = g->b;
+                        cv[j] = g->v;
+                    }
+                }
+                for (; k<kb; k++) {
+                    npyflint_madd_row(*((const flint*) (a_row + k*mi->a_n)),
+                                      ba + k*pn, bb + k*pn, bv + k*pn, ca, cb, cv, nl);
+                }
+                for (j=0; j<nb; j++) {
+                    g = (flint*) (c_row + j*mi->c_p);
+                    g->a = ca[j];
+                    g->b = cb[j];
+                    g->v = cv[j];
+                }
+            }
+        }
+    }
+    free(buf);
+}
+
+/// @brief The matmul row loop is split evenly between the threads
+static npyflint_parallel_info npyflint_parallel_matmul = {
+    npyflint_matmul_rows, 3, 1, NPYFLINT_STATIC, NULL, NPYFLINT_OUT_FLINT, {"matmul"}
+};
+
+/// @brief The inner loop for the (m,n),(n,p)->(m,p) matmul generalized ufunc
+static void npyflint_ufunc_matmul(char** args, const npy_intp* dim,
+                                  const npy_intp* std, void* NPY_UNUSED(data)) {
+    npyflint_matmul_info mi;
+    npyflint_job job;
+    npy_intp m = dim[1];
+    npy_intp i = 0, r;
+    int nthreads = 0;
+    double t0 = npyflint_stats_enabled ? npyflint_stats_now() : 0.0;
+    mi.n = dim[2];
+    mi.p = dim[3];
+    mi.a_n = std[4];
+    mi.b_n = std[5];
+    mi.b_p = std[6];
+    mi.c_p = std[8];
+    job.info = &npyflint_parallel_matmul;
+    job.std[0] = std[3];
+    job.std[1] = 0;
+    job.std[2] = std[7];
+    job.n = m;
+    job.data = &mi;
+    for (i=0; i<dim[0]; i++) {
+        job.args[0] = args[0] + i*std[0];
+        job.args[1] = args[1] + i*std[1];
+        job.args[2] = args[2] + i*std[2];
+        if (npyflint_num_threads < 2 || m < 2 ||
+            (double) m*mi.n*mi.p < NPYFLINT_MATMUL_PARALLEL_MIN ||
+            !PyThread_acquire_lock(npyflint_pool_lock, NOWAIT_LOCK)) {
+            npyflint_matmul_rows(job.args, &m, job.std, &mi);
+            continue;
+        }
+        nthreads = (npyflint_num_threads < m) ? npyflint_num_threads : (int) m;
+        job.chunk = (m + nthreads - 1)/nthreads;
+        npyflint_pool_run(&job, nthreads);
+    }
+    if (npyflint_stats_enabled) {
+        npyflint_stats_add(&npyflint_stats_loops, &npyflint_parallel_matmul.stats,
+                           dim[0]*m*mi.p, npyflint_stats_now() - t0);
+        for (i=0; i<dim[0]; i++) {
+            for (r=0; r<m; r++) {
+                npyflint_stats_add_widths(args[2] + i*std[2] + r*std[7], mi.c_p, mi.p, 0);
+            }
+        }
+    }
+}
+
+// ,,,,,,,,,,,,,,,,,,,,,,,,,
+// ---- batch functions ----
+// `````````````````````````
+// The batch functions exported through the c api capsule run the same loops as the
+// ufuncs, through the parallel dispatcher.
+
+/// @brief Macro to define the batch functions for a binary flint function
+#define NPYFLINT_BATCH_BINARY(name) \
+static void flint_##name##_strided(const flint* x, ptrdiff_t sx, \
+                                   const flint* y, ptrdiff_t sy, \
+                                   flint* z, ptrdiff_t sz, size_t n) { \
+    char* args[3] = {(char*) x, (char*) y, (char*) z}; \
+    npy_intp std[3] = {sx, sy, sz}; \
+    npy_intp dim = (npy_intp) n; \
+    npyflint_ufunc_parallel(args, &dim, std, &npyflint_parallel_##name); \
+} \
+static void flint_##name##_n(const flint* x, const flint* y, flint* z, size_t n) { \
+    flint_##name##_strided(x, sizeof(flint), y, sizeof(flint), z, sizeof(flint), n); \
+}
+/// @brief Macro to define the batch functions for a unary flint function
+#define NPYFLINT_BATCH_UNARY(name) \
+static void flint_##name##_strided(const flint* x, ptrdiff_t sx, \
+                                   flint* z, ptrdiff_t sz, size_t n) { \
+    char* args[2] = {(char*) x, (char*) z}; \
+    npy_intp std[2] = {sx, sz}; \
+    npy_intp dim = (npy_intp) n; \
+    npyflint_ufunc_parallel(args, &dim, std, &npyflint_parallel_##name); \
+} \
+static void flint_##name##_n(const flint* x, flint* z, size_t n) { \
+    flint_##name##_strided(x, sizeof(flint), z, sizeof(flint), n); \
+}
+FLINT_BATCH_BINARY_FUNCS(NPYFLINT_BATCH_BINARY)
+FLINT_BATCH_UNARY_FUNCS(NPYFLINT_BATCH_UNARY)
+
+// -----------------------------
+// ---- flint32 NumPy dtype ----
+// -----------------------------
+// The flint32 dtype stores the bounds and tracked value as floats, half the memory of
+// a flint. The array methods and ufunc loops widen each element to a flint, use the
+// flint functions, and round the result back out to a flint32.
+
+/// @brief Get a flint32 element from a numpy array
+/// @param data A pointer into the numpy array at the proper location
+/// @param arr A pointer to the full array
+/// @return A flint32 scalar with the value of the data element
+static PyObject* npyflint32_getitem(void* data, void* arr) {
+    flint32 f;
+    memcpy(&f, data, sizeof(flint32));
+    return pyflint32_from_flint32(f);
+}
+
+/// @brief Set an element in a numpy array, rounding the interval out to floats
+/// @param item The python object to set the data-element to
+/// @param data A pointer into the nummy array at the proper location
+/// @param arr A pointer to the full array
+/// @return 0 on success -1 on failure
+static int npyflint32_setitem(PyObject* item, void* data, void* arr) {
+    flint f = {0.0, 0.0, 0.0};
+    flint32 f32;
+    int ret = 0;
+    if (PyFlint_Check(item)) {
+        f = ((PyFlint*) item)->obval;
+    } else {
+        ret = pyflint_number_to_flint(item, &f);
+        if (ret == 0) {
+            PyErr_SetString(PyExc_TypeError,
+                "expected flint or numeric type.");
+        }
+        if (ret != 1) {
+            return -1;
+        }
+    }
+    f32 = flint_to_flint32(f);
+    memcpy(data, &f32, sizeof(flint32));
+    return 0;
+}
+
+/// @brief Reverse the byte order of a 32 bit word
+static inline npy_uint32 npyflint_bswap32(npy_uint32 x) {
+    x = (x << 16) | (x >> 16);
+    x = ((x & 0x00FF00FFU) << 8) | ((x >> 8) & 0x00FF00FFU);
+    return x;
+}
+
+/// @brief Copy one flint32 from src to dst, swapping the byte order of each float
+/// @param dst A pointer to the destination, which may be unaligned
+/// @param src A pointer to the source, which may be unaligned or equal to dst
+static inline void npyflint32_copy_swapped(char* dst, const char* src) {
+    npy_uint32 u[3];
+    memcpy(u, src, sizeof(flint32));
+    u[0] = npyflint_bswap32(u[0]);
+    u[1] = npyflint_bswap32(u[1]);
+    u[2] = npyflint_bswap32(u[2]);
+    memcpy(dst, u, sizeof(flint32));
+}
+
+/// @brief Copy an element of an ndarray from src to dst, possibly swapping
+/// @param dst A pointer to the destination
+/// @param src A pointer to the source, or NULL to only swap dst in place
+/// @param swap A flag to swap data, or simply copy
+/// @param arr A pointer to the full array
+static void npyflint32_copyswap(void* dst, void* src, int swap, void* NPY_UNUSED(arr)) {
+    if (swap) {
+        npyflint32_copy_swapped((char*) dst, (src == NULL) ? (char*) dst : (char*) src);
+    } else if (src != NULL) {
+        memmove(dst, src, sizeof(flint32));
+    }
+}
+
+/// @brief Copy a section of an ndarray from src to dst, possibly swapping
+/// @param dst A pointer to the destination
+/// @param dstride The number of bytes between entries in the destination array
+/// @param src A pointer to the source, or NULL to only swap dst in place
+/// @param sstride The number of bytes between entries in the source array
+/// @param n The number of elements to copy
+/// @param swap A flag to swap data, or simply copy
+/// @param arr A pointer to the full array
+static void npyflint32_copyswapn(void* dst, npy_intp dstride,
+                                 void* src, npy_intp sstride,
+                                 npy_intp n, int swap, void* NPY_UNUSED(arr)) {
+    char* _dst = (char*) dst;
+    char* _src = (char*) src;
+    npy_intp i;
+    if (_src == NULL) {
+        // Only swap the destination in place
+        _src = _dst;
+        sstride = dstride;
+        if (!swap) {
+            return;
+        }
+    }
+    if (swap) {
+        for (i = 0; i < n; i++) {
+            npyflint32_copy_swapped(_dst + i*dstride, _src + i*sstride);
+        }
+    } else if (dstride == sizeof(flint32) && sstride == sizeof(flint32)) {
+        memmove(_dst, _src, n*sizeof(flint32));
+    } else {
+        for (i = 0; i < n; i++) {
+            memmove(_dst + i*dstride, _src + i*sstride, sizeof(flint32));
+        }
+    }
+}
+
+/// @brief Check if an element of a numpy array is zero, with all zero components
+/// @param data a pointer to the element in a numpy array
+/// @param arr a pointer to the full array
+/// @return NPY_TRUE if zero, NPY_FALSE otherwise
+static npy_bool npyflint32_nonzero(void* data, void* arr) {
+    flint32 f;
+    memcpy(&f, data, sizeof(flint32));
+    return (f.a==0.0f && f.b==0.0f && f.v==0.0f)?NPY_FALSE:NPY_TRUE;
+}
+
+/// @brief Compare two elements of a numpy array, in the same order as flints
+/// NumPy uses this for sorting flint32 arrays, as well as for searchsorted.
+/// @param d1 A pointer to the first element
+/// @param d1 A pointer to the second element
+/// @param arr A pointer to the array
+/// @return 1 if *d1 > *d2, 0 if *d1 == *d2, -1 if *d1 < d2*
+static int npyflint32_compare(const void* d1, const void* d2, void* arr) {
+    flint32 f1, f2;
+    flint w1, w2;
+    memcpy(&f1, d1, sizeof(flint32));
+    memcpy(&f2, d2, sizeof(flint32));
+    w1 = flint32_to_flint(f1);
+    w2 = flint32_to_flint(f2);
+    return npyflint_compare(&w1, &w2, arr);
+}
+
+/// @brief Find the index of the largest element in a contiguous array of flint32s
+/// This is the first one with the largest upper bound, or the first one with NaN
+/// components if there are any, the same as for flints.
+/// @param data A pointer to the first element
+/// @param n The number of elements
+/// @param max_ind A pointer to the index to fill
+/// @param arr A pointer to the full array
+/// @return 0 on success
+static int npyflint32_argmax(void* data, npy_intp n,
+                             npy_intp* max_ind, void* NPY_UNUSED(arr)) {
+    const flint32* f = (const flint32*) data;
+    npy_intp i;
+    *max_ind = 0;
+    for (i=0; i<n; i++) {
+        if (flint_isnan(flint32_to_flint(f[i]))) {
+            *max_ind = i;
+            break;
+        }
+        if (f[i].b > f[*max_ind].b) {
+            *max_ind = i;
+        }
+    }
+    return 0;
+}
+
+/// @brief Find the index of the smallest element in a contiguous array of flint32s
+/// This is the first one with the smallest lower bound, or the first one with NaN
+/// components if there are any.
+/// @param data A pointer to the first element
+/// @param n The number of elements
+/// @param min_ind A pointer to the index to fill
+/// @param arr A pointer to the full array
+/// @return 0 on success
+static int npyflint32_argmin(void* data, npy_intp n,
+                             npy_intp* min_ind, void* NPY_UNUSED(arr)) {
+    const flint32* f = (const flint32*) data;
+    npy_intp i;
+    *min_ind = 0;
+    for (i=0; i<n; i++) {
+        if (flint_isnan(flint32_to_flint(f[i]))) {
+            *min_ind = i;
+            break;
+        }
+        if (f[i].a < f[*min_ind].a) {
+            *min_ind = i;
+        }
+    }
+    return 0;
+}
+
+/// @brief Fill an array with a single flint32 value
+/// @param buffer A pointer to the first element to fill in
+/// @param n The number of flint32s to fill in
+/// @param elem A pointer to the flint32 value to copy over
+/// @param arr A pointer to the full array
+static int npyflint32_fillwithscalar(void* buffer, npy_intp n,
+                                     void* elem, void* arr) {
+    flint32* fp = (flint32*) buffer;
+    flint32 f = *((flint32*) elem);
+    npy_intp i;
+    for (i=0; i<n; i++) {
+        fp[i] = f;
+    }
+    return 0;
+}
+
+// ,,,,,,,,,,,,,,,,,,,,,,,
+// ---- flint32 casts ----
+// ```````````````````````
+// Casts to flint32 round the intervals out, like setitem, and the casts from flint32
+// use the tracked value. Casting a flint32 to a flint is exact.
+/// @brief A macro to define conversions from a real scalar type to flint32
+#define SCALAR_TO_FLINT32(type) \
+static void npycast_##type##_flint32(void* from, void* to, npy_intp n, \
+                                     void* fromarr, void* toarr) { \
+    const type* _from = (const type*) from; \
+    flint32* _to = (flint32*) to; \
+    npy_intp i = 0; \
+    NPYFLINT_STATS_CAST(#type "->flint32", n) \
+    for (i=0; i<n; i++) { \
+        _to[i] = flint_to_flint32(double_to_flint((double) _from[i])); \
+    } \
+}
+/// @brief A macro to define conversions from flint32 to a real scalar type
+#define FLINT32_TO_TYPE(type) \
+static void npycast_flint32_##type(void* src, void* dst, npy_intp n, \
+                                   void* srcarr, void* dstarr) { \
+    const flint32* _src = (const flint32*) src; \
+    type* _dst = (type*) dst; \
+    npy_intp i = 0; \
+    NPYFLINT_STATS_CAST("flint32->" #type, n) \
+    for (i=0; i<n; i++) { \
+        _dst[i] = (type) _src[i].v; \
+    } \
+}
+SCALAR_TO_FLINT32(npy_bool)
+SCALAR_TO_FLINT32(npy_byte)
+SCALAR_TO_FLINT32(npy_short)
+SCALAR_TO_FLINT32(npy_int)
+SCALAR_TO_FLINT32(npy_long)
+SCALAR_TO_FLINT32(npy_longlong)
+SCALAR_TO_FLINT32(npy_ubyte)
+SCALAR_TO_FLINT32(npy_ushort)
+SCALAR_TO_FLINT32(npy_uint)
+SCALAR_TO_FLINT32(npy_ulong)
+SCALAR_TO_FLINT32(npy_ulonglong)
+SCALAR_TO_FLINT32(npy_double)
+SCALAR_TO_FLINT32(npy_longdouble)
+static void npycast_npy_float_flint32(void* from, void* to, npy_intp n,
+                                      void* fromarr, void* toarr) {
+    const npy_float* _from = (const npy_float*) from;
+    flint32* _to = (flint32*) to;
+    npy_intp i = 0;
+    NPYFLINT_STATS_CAST("npy_float->flint32", n)
+    for (i=0; i<n; i++) {
+        _to[i] = float_to_flint32(_from[i]);
+    }
+}
+static void npycast_flint_flint32(void* from, void* to, npy_intp n,
+                                  void* fromarr, void* toarr) {
+    const flint* _from = (const flint*) from;
+    flint32* _to = (flint32*) to;
+    npy_intp i = 0;
+    NPYFLINT_STATS_CAST("flint->flint32", n)
+    for (i=0; i<n; i++) {
+        _to[i] = flint_to_flint32(_from[i]);
+    }
+}
+// The bool cast is true for any non-zero value, like for floats
+static void npycast_flint32_npy_bool(void* src, void* dst, npy_intp n,
+                                     void* srcarr, void* dstarr) {
+    const flint32* _src = (const flint32*) src;
+    npy_bool* _dst = (npy_bool*) dst;
+    npy_intp i = 0;
+    NPYFLINT_STATS_CAST("flint32->npy_bool", n)
+    for (i=0; i<n; i++) {
+        _dst[i] = (_src[i].v != 0.0f);
+    }
+}
+FLINT32_TO_TYPE(npy_byte)
+FLINT32_TO_TYPE(npy_short)
+FLINT32_TO_TYPE(npy_int)
+FLINT32_TO_TYPE(npy_long)
+FLINT32_TO_TYPE(npy_longlong)
+FLINT32_TO_TYPE(npy_ubyte)
+FLINT32_TO_TYPE(npy_ushort)
+FLINT32_TO_TYPE(npy_uint)
+FLINT32_TO_TYPE(npy_ulong)
+FLINT32_TO_TYPE(npy_ulonglong)
+FLINT32_TO_TYPE(npy_float)
+FLINT32_TO_TYPE(npy_double)
+FLINT32_TO_TYPE(npy_longdouble)
+static void npycast_flint32_flint(void* src, void* dst, npy_intp n,
+                                  void* srcarr, void* dstarr) {
+    const flint32* _src = (const flint32*) src;
+    flint* _dst = (flint*) dst;
+    npy_intp i = 0;
+    NPYFLINT_STATS_CAST("flint32->flint", n)
+    for (i=0; i<n; i++) {
+        _dst[i] = flint32_to_flint(_src[i]);
+    }
+}
+
+// ,,,,,,,,,,,,,,,,,,,,,,,,,,,,
+// ---- flint32 ufunc loops ----
+// ````````````````````````````
+// The loops are named npyflint_ufunc_f32_{name}, so that they can use the same parallel
+// dispatcher as the flint loops.
+/// @brief Narrow a flint result to a flint32
+#define NPYFLINT32_NARROW(f) flint_to_flint32(f)
+/// @brief Keep a boolean result as is
+#define NPYFLINT32_BOOL(f) ((npy_bool) (f))
+
+/// @brief Macro to define the internal loop for a unary flint32 universal function
+/// @param name The name of the flint function
+/// @param out_type The data type of the output
+/// @param narrow The macro that converts the flint function output to out_type
+#define NPYFLINT32_UNARY_UFUNC(name, out_type, narrow) \
+static void npyflint_ufunc_f32_##name(char** args, const npy_intp* dim, \
+                                      const npy_intp* std, void* data) { \
+    char* in_ptr = args[0]; \
+    char* out_ptr = args[1]; \
+    npy_intp in_std = std[0]; \
+    npy_intp out_std = std[1]; \
+    npy_intp n = dim[0]; \
+    npy_intp i = 0; \
+    for (i=0; i<n; i++) { \
+        *((out_type*) out_ptr) = narrow(flint_##name(flint32_to_flint(*((flint32*) in_ptr)))); \
+        in_ptr += in_std; \
+        out_ptr += out_std; \
+    } \
+}
+
+/// @brief Macro to define the internal loop for a binary flint32 universal function
+/// @param name The name of the flint function
+/// @param out_type The data type of the output
+/// @param narrow The macro that converts the flint function output to out_type
+#define NPYFLINT32_BINARY_UFUNC(name, out_type, narrow) \
+static void npyflint_ufunc_f32_##name(char** args, const npy_intp* dim, \
+                                      const npy_intp* std, void* data) { \
+    char* in0_ptr = args[0]; \
+    char* in1_ptr = args[1]; \
+    char* out_ptr = args[2]; \
+    npy_intp in0_std = std[0]; \
+    npy_intp in1_std = std[1]; \
+    npy_intp out_std = std[2]; \
+    npy_intp n = dim[0]; \
+    npy_intp i = 0; \
     for (i=0; i<n; i++) { \
-        in0_f = *((in0_type*) in0_ptr); \
-        in1_f = *((in1_type*) in1_ptr); \
-        *((out_type*) out_ptr) = flint_##name(in0_f, in1_f); \
+        *((out_type*) out_ptr) = narrow(flint_##name( \
+            flint32_to_flint(*((flint32*) in0_ptr)), \
+            flint32_to_flint(*((flint32*) in1_ptr)))); \
         in0_ptr += in0_std; \
         in1_ptr += in1_std; \
         out_ptr += out_std; \
     } \
 }
+
+/// @brief Macro to define the reduce loop for a flint32 universal function
+/// @param name The name of the flint function
+/// The running result is kept as a flint and is only narrowed once at the end, so
+/// the bounds are not rounded out to floats after every element.
+#define NPYFLINT32_REDUCE_UFUNC(name) \
+static void npyflint_reduce_f32_##name(char** args, const npy_intp* dim, \
+                                       const npy_intp* std, void* data) { \
+    char* in_ptr = args[1]; \
+    npy_intp in_std = std[1]; \
+    npy_intp n = dim[0]; \
+    npy_intp i = 0; \
+    flint acc = flint32_to_flint(*((flint32*) args[0])); \
+    for (i=0; i<n; i++) { \
+        acc = flint_##name(acc, flint32_to_flint(*((flint32*) in_ptr))); \
+        in_ptr += in_std; \
+    } \
+    *((flint32*) args[0]) = flint_to_flint32(acc); \
+}
+
 // Arithmetic
-NPYFLINT_UNARY_UFUNC(negative, flint)
-NPYFLINT_UNARY_UFUNC(positive, flint)
-NPYFLINT_BINARY_UFUNC(add, flint, flint, flint)
-NPYFLINT_BINARY_UFUNC(subtract, flint, flint, flint)
-NPYFLINT_BINARY_UFUNC(multiply, flint, flint, flint)
-NPYFLINT_BINARY_UFUNC(divide, flint, flint, flint)
-NPYFLINT_BINARY_UFUNC(power, flint, flint, flint)
+NPYFLINT32_UNARY_UFUNC(negative, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(positive, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_BINARY_UFUNC(add, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_BINARY_UFUNC(subtract, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_BINARY_UFUNC(multiply, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_BINARY_UFUNC(divide, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_BINARY_UFUNC(power, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(square, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_BINARY_UFUNC(minimum, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_BINARY_UFUNC(maximum, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_BINARY_UFUNC(fmin, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_BINARY_UFUNC(fmax, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_REDUCE_UFUNC(add)
+NPYFLINT32_REDUCE_UFUNC(multiply)
+NPYFLINT32_REDUCE_UFUNC(minimum)
+NPYFLINT32_REDUCE_UFUNC(maximum)
+NPYFLINT32_REDUCE_UFUNC(fmin)
+NPYFLINT32_REDUCE_UFUNC(fmax)
 // Comparisons
-NPYFLINT_BINARY_UFUNC(eq, flint, flint, npy_bool)
-NPYFLINT_BINARY_UFUNC(ne, flint, flint, npy_bool)
-NPYFLINT_BINARY_UFUNC(lt, flint, flint, npy_bool)
-NPYFLINT_BINARY_UFUNC(le, flint, flint, npy_bool)
-NPYFLINT_BINARY_UFUNC(gt, flint, flint, npy_bool)
-NPYFLINT_BINARY_UFUNC(ge, flint, flint, npy_bool)
+NPYFLINT32_BINARY_UFUNC(eq, npy_bool, NPYFLINT32_BOOL)
+NPYFLINT32_BINARY_UFUNC(ne, npy_bool, NPYFLINT32_BOOL)
+NPYFLINT32_BINARY_UFUNC(lt, npy_bool, NPYFLINT32_BOOL)
+NPYFLINT32_BINARY_UFUNC(le, npy_bool, NPYFLINT32_BOOL)
+NPYFLINT32_BINARY_UFUNC(gt, npy_bool, NPYFLINT32_BOOL)
+NPYFLINT32_BINARY_UFUNC(ge, npy_bool, NPYFLINT32_BOOL)
 // elementary functions
-NPYFLINT_UNARY_UFUNC(isnan, npy_bool)
-NPYFLINT_UNARY_UFUNC(isinf, npy_bool)
-NPYFLINT_UNARY_UFUNC(isfinite, npy_bool)
-NPYFLINT_UNARY_UFUNC(absolute, flint)
-NPYFLINT_UNARY_UFUNC(sqrt, flint)
-NPYFLINT_UNARY_UFUNC(cbrt, flint)
-NPYFLINT_BINARY_UFUNC(hypot, flint, flint, flint)
-NPYFLINT_UNARY_UFUNC(exp, flint)
-NPYFLINT_UNARY_UFUNC(exp2, flint)
-NPYFLINT_UNARY_UFUNC(expm1, flint)
-NPYFLINT_UNARY_UFUNC(log, flint)
-NPYFLINT_UNARY_UFUNC(log10, flint)
-NPYFLINT_UNARY_UFUNC(log2, flint)
-NPYFLINT_UNARY_UFUNC(log1p, flint)
-NPYFLINT_UNARY_UFUNC(sin, flint)
-NPYFLINT_UNARY_UFUNC(cos, flint)
-NPYFLINT_UNARY_UFUNC(tan, flint)
-NPYFLINT_UNARY_UFUNC(asin, flint)
-NPYFLINT_UNARY_UFUNC(acos, flint)
-NPYFLINT_UNARY_UFUNC(atan, flint)
-NPYFLINT_BINARY_UFUNC(atan2, flint, flint, flint)
-NPYFLINT_UNARY_UFUNC(sinh, flint)
-NPYFLINT_UNARY_UFUNC(cosh, flint)
-NPYFLINT_UNARY_UFUNC(tanh, flint)
-NPYFLINT_UNARY_UFUNC(asinh, flint)
-NPYFLINT_UNARY_UFUNC(acosh, flint)
-NPYFLINT_UNARY_UFUNC(atanh, flint)
+NPYFLINT32_UNARY_UFUNC(isnan, npy_bool, NPYFLINT32_BOOL)
+NPYFLINT32_UNARY_UFUNC(isinf, npy_bool, NPYFLINT32_BOOL)
+NPYFLINT32_UNARY_UFUNC(isfinite, npy_bool, NPYFLINT32_BOOL)
+NPYFLINT32_UNARY_UFUNC(absolute, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(sqrt, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(cbrt, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_BINARY_UFUNC(hypot, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(exp, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(exp2, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(expm1, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(log, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(log10, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(log2, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(log1p, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(sin, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(cos, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(tan, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(asin, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(acos, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(atan, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_BINARY_UFUNC(atan2, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(sinh, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(cosh, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(tanh, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(asinh, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(acosh, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(atanh, flint32, NPYFLINT32_NARROW)
+// rounding and remainders
+NPYFLINT32_UNARY_UFUNC(floor, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(ceil, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(trunc, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_UNARY_UFUNC(rint, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_BINARY_UFUNC(fmod, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_BINARY_UFUNC(remainder, flint32, NPYFLINT32_NARROW)
+NPYFLINT32_BINARY_UFUNC(floor_divide, flint32, NPYFLINT32_NARROW)
+
+/// @brief The internal loop for the flint32 modf, with the fractional and integer
+///        parts as outputs
+static void npyflint_ufunc_f32_modf(char** args, const npy_intp* dim,
+                                    const npy_intp* std, void* data) {
+    char* in_ptr = args[0];
+    char* frac_ptr = args[1];
+    char* int_ptr = args[2];
+    npy_intp in_std = std[0];
+    npy_intp frac_std = std[1];
+    npy_intp int_std = std[2];
+    npy_intp n = dim[0];
+    npy_intp i = 0;
+    flint ipart;
+    for (i=0; i<n; i++) {
+        *((flint32*) frac_ptr) = flint_to_flint32(
+            flint_modf(flint32_to_flint(*((flint32*) in_ptr)), &ipart));
+        *((flint32*) int_ptr) = flint_to_flint32(ipart);
+        in_ptr += in_std;
+        frac_ptr += frac_std;
+        int_ptr += int_std;
+    }
+}
+
+// Arithmetic
+NPYFLINT_PARALLEL(f32_negative, 2, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_positive, 2, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL_REDUCE(f32_add, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_subtract, 3, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL_REDUCE(f32_multiply, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_divide, 3, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_power, 3, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_square, 2, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL_REDUCE(f32_minimum, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL_REDUCE(f32_maximum, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL_REDUCE(f32_fmin, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL_REDUCE(f32_fmax, NPYFLINT_OUT_FLINT32)
+// Comparisons
+NPYFLINT_PARALLEL(f32_eq, 3, NPYFLINT_STATIC, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL(f32_ne, 3, NPYFLINT_STATIC, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL(f32_lt, 3, NPYFLINT_STATIC, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL(f32_le, 3, NPYFLINT_STATIC, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL(f32_gt, 3, NPYFLINT_STATIC, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL(f32_ge, 3, NPYFLINT_STATIC, NPYFLINT_OUT_BOOL)
+// elementary functions
+NPYFLINT_PARALLEL(f32_isnan, 2, NPYFLINT_STATIC, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL(f32_isinf, 2, NPYFLINT_STATIC, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL(f32_isfinite, 2, NPYFLINT_STATIC, NPYFLINT_OUT_BOOL)
+NPYFLINT_PARALLEL(f32_absolute, 2, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_sqrt, 2, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_cbrt, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_hypot, 3, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_exp, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_exp2, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_expm1, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_log, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_log10, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_log2, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_log1p, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_sin, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_cos, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_tan, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_asin, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_acos, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_atan, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_atan2, 3, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_sinh, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_cosh, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_tanh, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_asinh, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_acosh, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_atanh, 2, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+// rounding and remainders
+NPYFLINT_PARALLEL(f32_floor, 2, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_ceil, 2, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_trunc, 2, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_rint, 2, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_fmod, 3, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_remainder, 3, NPYFLINT_DYNAMIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL(f32_floor_divide, 3, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT32)
+NPYFLINT_PARALLEL_TWO_OUT(f32_modf, NPYFLINT_STATIC, NPYFLINT_OUT_FLINT32)
+
+/// @brief Set the number of threads used by the flint ufunc loops
+static PyObject* npyflint_set_num_threads(PyObject* self, PyObject* args) {
+    int n;
+    if (!PyArg_ParseTuple(args, "i", &n)) {
+        return NULL;
+    }
+    if (n < 1 || n > NPYFLINT_MAX_THREADS) {
+        PyErr_Format(PyExc_ValueError,
+            "The number of threads must be between 1 and %d", NPYFLINT_MAX_THREADS);
+        return NULL;
+    }
+    if (npyflint_set_threads(n) < 0) {
+        PyErr_Format(PyExc_RuntimeError,
+            "Could only start %d threads", npyflint_num_threads);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+/// @brief Get the number of threads used by the flint ufunc loops
+static PyObject* npyflint_get_num_threads(PyObject* self, PyObject* NPY_UNUSED(args)) {
+    return PyLong_FromLong(npyflint_num_threads);
+}
+
+/// @brief Rebuild the pool in a forked child, which only keeps the forking thread
+static PyObject* npyflint_after_fork(PyObject* self, PyObject* NPY_UNUSED(args)) {
+    int n = npyflint_num_threads;
+    // The old locks may be held by threads that do not exist in the child
+    npyflint_pool_lock = PyThread_allocate_lock();
+    npyflint_job_lock = PyThread_allocate_lock();
+    npyflint_stats_lock = PyThread_allocate_lock();
+    npyflint_num_workers = 0;
+    npyflint_num_threads = 1;
+    if (npyflint_pool_lock == NULL || npyflint_job_lock == NULL ||
+        npyflint_stats_lock == NULL) {
+        return PyErr_NoMemory();
+    }
+    if (n > 1) {
+        npyflint_set_threads(n);
+    }
+    Py_RETURN_NONE;
+}
+
+/// @brief Get a float64 view of one part of every flint in a flint array
+/// The view has the same shape and strides as the flint array, starts at the offset of
+/// the part inside the flint, and keeps the flint array alive as its base.
+static PyObject* npyflint_component_view(PyObject* self, PyObject* args) {
+    PyArrayObject* arr;
+    PyArray_Descr* descr;
+    PyObject* view;
+    int offset;
+    if (!PyArg_ParseTuple(args, "O!i", &PyArray_Type, &arr, &offset)) {
+        return NULL;
+    }
+    if (PyArray_TYPE(arr) != NPY_FLINT) {
+        PyErr_SetString(PyExc_TypeError, "The array must have dtype flint");
+        return NULL;
+    }
+    if (offset != offsetof(flint, a) && offset != offsetof(flint, b) &&
+        offset != offsetof(flint, v)) {
+        PyErr_SetString(PyExc_ValueError, "The offset must be that of a, b, or v");
+        return NULL;
+    }
+    descr = PyArray_DescrFromType(NPY_DOUBLE);
+    view = PyArray_NewFromDescr(&PyArray_Type, descr, PyArray_NDIM(arr),
+                                PyArray_DIMS(arr), PyArray_STRIDES(arr),
+                                PyArray_BYTES(arr) + offset,
+                                PyArray_FLAGS(arr) & NPY_ARRAY_WRITEABLE, NULL);
+    if (view == NULL) {
+        return NULL;
+    }
+    Py_INCREF(arr);
+    if (PyArray_SetBaseObject((PyArrayObject*) view, (PyObject*) arr) < 0) {
+        Py_DECREF(view);
+        return NULL;
+    }
+    return view;
+}
+
+/// @brief Get a flint array view of three float64 arrays that hold the a, b, and v
+/// parts of the same flints, like the views from npyflint_component_view
+/// @return The flint array, or None if the three arrays are not laid out as flints
+static PyObject* npyflint_flint_view(PyObject* self, PyObject* args) {
+    PyArrayObject* a;
+    PyArrayObject* b;
+    PyArrayObject* v;
+    PyArray_Descr* descr;
+    PyObject* view;
+    int nd, flags;
+    if (!PyArg_ParseTuple(args, "O!O!O!", &PyArray_Type, &a, &PyArray_Type, &b,
+                          &PyArray_Type, &v)) {
+        return NULL;
+    }
+    nd = PyArray_NDIM(a);
+    if (PyArray_TYPE(a) != NPY_DOUBLE || PyArray_TYPE(b) != NPY_DOUBLE ||
+        PyArray_TYPE(v) != NPY_DOUBLE || !PyArray_ISNOTSWAPPED(a) ||
+        !PyArray_ISNOTSWAPPED(b) || !PyArray_ISNOTSWAPPED(v) ||
+        !PyArray_ISALIGNED(a) || PyArray_NDIM(b) != nd || PyArray_NDIM(v) != nd ||
+        !PyArray_CompareLists(PyArray_DIMS(a), PyArray_DIMS(b), nd) ||
+        !PyArray_CompareLists(PyArray_DIMS(a), PyArray_DIMS(v), nd) ||
+        !PyArray_CompareLists(PyArray_STRIDES(a), PyArray_STRIDES(b), nd) ||
+        !PyArray_CompareLists(PyArray_STRIDES(a), PyArray_STRIDES(v), nd) ||
+        PyArray_BYTES(b) != PyArray_BYTES(a) + offsetof(flint, b) ||
+        PyArray_BYTES(v) != PyArray_BYTES(a) + offsetof(flint, v)) {
+        Py_RETURN_NONE;
+    }
+    flags = PyArray_FLAGS(a) & PyArray_FLAGS(b) & PyArray_FLAGS(v) & NPY_ARRAY_WRITEABLE;
+    descr = PyArray_DescrFromType(NPY_FLINT);
+    view = PyArray_NewFromDescr(&PyArray_Type, descr, nd, PyArray_DIMS(a),
+                                PyArray_STRIDES(a), PyArray_BYTES(a), flags, NULL);
+    if (view == NULL) {
+        return NULL;
+    }
+    Py_INCREF(a);
+    if (PyArray_SetBaseObject((PyArrayObject*) view, (PyObject*) a) < 0) {
+        Py_DECREF(view);
+        return NULL;
+    }
+    return view;
+}
+
+/// @brief Fill flints from arrays of lower bounds, upper bounds, and tracked values
+/// @param data The pointers to the a, b, (v,) and flint arrays
+/// @param std The strides of the a, b, (v,) and flint arrays
+/// @param n The number of elements
+/// @param nin The number of double arrays, 2 if the tracked values are the midpoints
+static void npyflint_fill_from_bounds(char** data, const npy_intp* std, npy_intp n,
+                                      int nin) {
+    char* a_ptr = data[0];
+    char* b_ptr = data[1];
+    char* v_ptr = data[2];
+    char* f_ptr = data[nin];
+    npy_intp a_std = std[0], b_std = std[1], v_std = std[2], f_std = std[nin];
+    npy_intp i;
+    flint* f;
+    if (nin == 2) {
+        for (i = 0; i < n; i++) {
+            f = (flint*) f_ptr;
+            f->a = *((double*) a_ptr);
+            f->b = *((double*) b_ptr);
+            f->v = 0.5*(f->a+f->b);
+            a_ptr += a_std; b_ptr += b_std; f_ptr += f_std;
+        }
+    } else {
+        for (i = 0; i < n; i++) {
+            f = (flint*) f_ptr;
+            f->a = *((double*) a_ptr);
+            f->b = *((double*) b_ptr);
+            f->v = *((double*) v_ptr);
+            a_ptr += a_std; b_ptr += b_std; v_ptr += v_std; f_ptr += f_std;
+        }
+    }
+}
+
+/// @brief Make a flint array from arrays of lower bounds, upper bounds, and tracked
+/// values, broadcast against each other and filled in a single pass
+/// @param args The a, b, and optional v array-like objects
+/// @return A new flint array, or NULL on failure
+static PyObject* npyflint_from_bounds(PyObject* NPY_UNUSED(self), PyObject* args,
+                                      PyObject* kwargs) {
+    static char* kwlist[] = {"a", "b", "v", NULL};
+    PyObject* in[3] = {NULL, NULL, NULL};
+    PyArrayObject* op[4] = {NULL, NULL, NULL, NULL};
+    PyArray_Descr* op_dtypes[4] = {NULL, NULL, NULL, NULL};
+    npy_uint32 op_flags[4];
+    NpyIter* iter = NULL;
+    NpyIter_IterNextFunc* iternext;
+    char** data;
+    npy_intp* std;
+    npy_intp* size_ptr;
+    PyObject* ret = NULL;
+    int nin, i, needs_api;
+    NPY_BEGIN_THREADS_DEF
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|O:from_bounds", kwlist,
+                                     &in[0], &in[1], &in[2])) {
+        return NULL;
+    }
+    nin = (in[2] == NULL || in[2] == Py_None) ? 2 : 3;
+    for (i = 0; i < nin; i++) {
+        op[i] = (PyArrayObject*) PyArray_FROM_O(in[i]);
+        if (op[i] == NULL) {
+            goto done;
+        }
+        op_dtypes[i] = PyArray_DescrFromType(NPY_DOUBLE);
+        op_flags[i] = NPY_ITER_READONLY | NPY_ITER_NBO | NPY_ITER_ALIGNED;
+    }
+    op_dtypes[nin] = PyArray_DescrFromType(NPY_FLINT);
+    op_flags[nin] = NPY_ITER_WRITEONLY | NPY_ITER_ALLOCATE;
+    iter = NpyIter_MultiNew(nin+1, op,
+                            NPY_ITER_EXTERNAL_LOOP | NPY_ITER_BUFFERED |
+                            NPY_ITER_GROWINNER | NPY_ITER_ZEROSIZE_OK,
+                            NPY_KEEPORDER, NPY_SAME_KIND_CASTING, op_flags, op_dtypes);
+    if (iter == NULL) {
+        goto done;
+    }
+    if (NpyIter_GetIterSize(iter) > 0) {
+        iternext = NpyIter_GetIterNext(iter, NULL);
+        if (iternext == NULL) {
+            goto done;
+        }
+        data = NpyIter_GetDataPtrArray(iter);
+        std = NpyIter_GetInnerStrideArray(iter);
+        size_ptr = NpyIter_GetInnerLoopSizePtr(iter);
+        needs_api = NpyIter_IterationNeedsAPI(iter);
+        if (!needs_api) {
+            NPY_BEGIN_THREADS;
+        }
+        do {
+            npyflint_fill_from_bounds(data, std, *size_ptr, nin);
+        } while (iternext(iter));
+        NPY_END_THREADS;
+        if (needs_api && PyErr_Occurred()) {
+            goto done;
+        }
+    }
+    ret = (PyObject*) NpyIter_GetOperandArray(iter)[nin];
+    Py_INCREF(ret);
+
+done:
+    if (iter != NULL) {
+        NpyIter_Deallocate(iter);
+    }
+    for (i = 0; i < 4; i++) {
+        Py_XDECREF(op[i]);
+        Py_XDECREF(op_dtypes[i]);
+    }
+    return ret;
+}
+
+// ##################################
+// ---- Fused expression program ----
+// ##################################
+
+/// @brief The number of elements run through a fused expression at a time
+/// The intermediate values of one block fit in the L1 cache, so a chain of functions
+/// only reads the inputs and writes the result once.
+#define NPYFLINT_EVAL_BLOCK 128
+/// @brief The maximum number of intermediate values in a fused expression
+#define NPYFLINT_EVAL_MAX_REGS 32
+
+/// @brief The unary flint functions that can be used in a fused expression
+#define NPYFLINT_EVAL_UNARY(X) \
+    X(negative) X(positive) X(absolute) X(square) X(sqrt) X(cbrt) \
+    X(exp) X(exp2) X(expm1) X(log) X(log10) X(log2) X(log1p) \
+    X(sin) X(cos) X(tan) X(asin) X(acos) X(atan) \
+    X(sinh) X(cosh) X(tanh) X(asinh) X(acosh) X(atanh) \
+    X(floor) X(ceil) X(trunc) X(rint)
+/// @brief The binary flint functions that can be used in a fused expression
+#define NPYFLINT_EVAL_BINARY(X) \
+    X(add) X(subtract) X(multiply) X(divide) X(power) X(hypot) X(atan2) \
+    X(minimum) X(maximum) X(fmin) X(fmax) X(fmod) X(remainder) X(floor_divide)
+
+#define NPYFLINT_EVAL_ENUM(name) NPYFLINT_OP_##name,
+#define NPYFLINT_EVAL_NAME(name) #name,
+
+/// @brief The operations of a fused expression program
+/// The program runs on a stack of blocks: load pushes an input, the unary functions
+/// and power_int replace the top block, the binary functions replace the top two
+/// blocks, and fma replaces the top three.
+enum npyflint_eval_op {
+    NPYFLINT_OP_load,
+    NPYFLINT_OP_power_int,
+    NPYFLINT_OP_fma,
+    NPYFLINT_EVAL_UNARY(NPYFLINT_EVAL_ENUM)
+    NPYFLINT_EVAL_BINARY(NPYFLINT_EVAL_ENUM)
+    NPYFLINT_EVAL_NUM_OPS
+};
+
+/// @brief The names of the operations, exported to python as flint._evaluate_ops
+static const char* npyflint_eval_names[] = {
+    "load", "power_int", "fma",
+    NPYFLINT_EVAL_UNARY(NPYFLINT_EVAL_NAME)
+    NPYFLINT_EVAL_BINARY(NPYFLINT_EVAL_NAME)
+};
+
+/// @brief One step of a fused expression program
+typedef struct {
+    int op;
+    /// The input index for load or the exponent for power_int
+    npy_int64 arg;
+} npyflint_eval_step;
+
+#define NPYFLINT_EVAL_UNARY_CASE(name) \
+        case NPYFLINT_OP_##name: \
+            r = regs + (sp-1)*NPYFLINT_EVAL_BLOCK; \
+            for (j=0; j<m; j++) { \
+                r[j] = flint_##name(r[j]); \
+            } \
+            break;
+
+#define NPYFLINT_EVAL_BINARY_CASE(name) \
+        case NPYFLINT_OP_##name: \
+            sp--; \
+            r = regs + (sp-1)*NPYFLINT_EVAL_BLOCK; \
+            for (j=0; j<m; j++) { \
+                r[j] = flint_##name(r[j], r[j+NPYFLINT_EVAL_BLOCK]); \
+            } \
+            break;
+
+/// @brief Run a fused expression program over one block of elements
+/// @param prog The steps of the program
+/// @param len The number of steps
+/// @param regs The scratch blocks
+/// @param data The pointers to the first element of the inputs and the output
+/// @param std The strides of the inputs and the output
+/// @param nin The number of inputs
+/// @param m The number of elements, at most NPYFLINT_EVAL_BLOCK
+static void npyflint_eval_block(const npyflint_eval_step* prog, int len, flint* regs,
+                                char** data, const npy_intp* std, int nin, npy_intp m) {
+    int pc, sp = 0;
+    npy_intp j;
+    flint* r;
+    char* p;
+    for (pc=0; pc<len; pc++) {
+        switch (prog[pc].op) {
+        case NPYFLINT_OP_load:
+            r = regs + (sp++)*NPYFLINT_EVAL_BLOCK;
+            p = data[prog[pc].arg];
+            for (j=0; j<m; j++) {
+                r[j] = *((flint*) p);
+                p += std[prog[pc].arg];
+            }
+            break;
+        case NPYFLINT_OP_power_int:
+            r = regs + (sp-1)*NPYFLINT_EVAL_BLOCK;
+            for (j=0; j<m; j++) {
+                r[j] = flint_power_int(r[j], prog[pc].arg);
+            }
+            break;
+        case NPYFLINT_OP_fma:
+            sp -= 2;
+            r = regs + (sp-1)*NPYFLINT_EVAL_BLOCK;
+            for (j=0; j<m; j++) {
+                r[j] = flint_fma(r[j], r[j+NPYFLINT_EVAL_BLOCK], r[j+2*NPYFLINT_EVAL_BLOCK]);
+            }
+            break;
+        NPYFLINT_EVAL_UNARY(NPYFLINT_EVAL_UNARY_CASE)
+        NPYFLINT_EVAL_BINARY(NPYFLINT_EVAL_BINARY_CASE)
+        }
+    }
+    p = data[nin];
+    for (j=0; j<m; j++) {
+        *((flint*) p) = regs[j];
+        p += std[nin];
+    }
+}
+
+/// @brief Read and check a fused expression program
+/// @param seq The flat sequence of (op, arg) pairs
+/// @param nin The number of inputs
+/// @param len Set to the number of steps
+/// @param depth Set to the number of scratch blocks the program needs
+/// @return A new array of steps, or NULL with an exception set
+static npyflint_eval_step* npyflint_eval_parse(PyObject* seq, int nin, int* len,
+                                               int* depth) {
+    PyObject* fast;
+    npyflint_eval_step* prog;
+    Py_ssize_t n, i;
+    int sp = 0;
+    fast = PySequence_Fast(seq, "the program must be a sequence of integers");
+    if (fast == NULL) {
+        return NULL;
+    }
+    n = PySequence_Fast_GET_SIZE(fast)/2;
+    if (PySequence_Fast_GET_SIZE(fast) % 2 != 0 || n == 0 || n > INT_MAX) {
+        Py_DECREF(fast);
+        PyErr_SetString(PyExc_ValueError, "the program must be a list of (op, arg) pairs");
+        return NULL;
+    }
+    prog = PyMem_New(npyflint_eval_step, n);
+    if (prog == NULL) {
+        Py_DECREF(fast);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    *depth = 0;
+    for (i=0; i<n; i++) {
+        prog[i].op = (int) PyLong_AsLong(PySequence_Fast_GET_ITEM(fast, 2*i));
+        prog[i].arg = PyLong_AsLongLong(PySequence_Fast_GET_ITEM(fast, 2*i+1));
+        if (PyErr_Occurred()) {
+            goto fail;
+        }
+        if (prog[i].op < 0 || prog[i].op >= NPYFLINT_EVAL_NUM_OPS) {
+            PyErr_Format(PyExc_ValueError, "unknown operation %d in the program", prog[i].op);
+            goto fail;
+        }
+        if (prog[i].op == NPYFLINT_OP_load) {
+            if (prog[i].arg < 0 || prog[i].arg >= nin) {
+                PyErr_SetString(PyExc_ValueError, "the program loads a missing input");
+                goto fail;
+            }
+            sp++;
+        } else if (prog[i].op == NPYFLINT_OP_fma) {
+            sp -= 2;
+        } else if (prog[i].op >= NPYFLINT_OP_add) {
+            sp -= 1;
+        }
+        if (sp < 1) {
+            PyErr_SetString(PyExc_ValueError, "the program uses more values than it loads");
+            goto fail;
+        }
+        *depth = (sp > *depth) ? sp : *depth;
+    }
+    if (sp != 1) {
+        PyErr_SetString(PyExc_ValueError, "the program must leave a single value");
+        goto fail;
+    }
+    if (*depth > NPYFLINT_EVAL_MAX_REGS) {
+        PyErr_SetString(PyExc_ValueError, "the expression is too deeply nested");
+        goto fail;
+    }
+    Py_DECREF(fast);
+    *len = (int) n;
+    return prog;
+
+fail:
+    Py_DECREF(fast);
+    PyMem_Free(prog);
+    return NULL;
+}
+
+/// @brief The performance counters of the fused expressions
+static npyflint_stats_entry npyflint_stats_evaluate = {"evaluate"};
+
+/// @brief Run a fused expression program over broadcast input arrays in one pass
+/// @param args The program, the tuple of inputs, and the optional output array
+/// @return The output array, or NULL on failure
+static PyObject* npyflint_evaluate(PyObject* NPY_UNUSED(self), PyObject* args) {
+    PyObject* program;
+    PyObject* inputs;
+    PyObject* out = Py_None;
+    PyArrayObject* op[NPY_MAXARGS];
+    PyArray_Descr* op_dtypes[NPY_MAXARGS];
+    npy_uint32 op_flags[NPY_MAXARGS];
+    npyflint_eval_step* prog = NULL;
+    flint* regs = NULL;
+    NpyIter* iter = NULL;
+    NpyIter_IterNextFunc* iternext;
+    char** data;
+    char* block[NPY_MAXARGS];
+    npy_intp* std;
+    npy_intp* size_ptr;
+    npy_intp n, start, m;
+    PyObject* ret = NULL;
+    int nin, len, depth, i, needs_api;
+    double t0 = npyflint_stats_enabled ? npyflint_stats_now() : 0.0;
+    NPY_BEGIN_THREADS_DEF
+
+    if (!PyArg_ParseTuple(args, "OO!|O:_evaluate", &program, &PyTuple_Type, &inputs, &out)) {
+        return NULL;
+    }
+    if (PyTuple_GET_SIZE(inputs) >= NPY_MAXARGS) {
+        PyErr_Format(PyExc_ValueError, "an expression can use at most %d arrays",
+                     NPY_MAXARGS-1);
+        return NULL;
+    }
+    nin = (int) PyTuple_GET_SIZE(inputs);
+    for (i = 0; i < NPY_MAXARGS; i++) {
+        op[i] = NULL;
+        op_dtypes[i] = NULL;
+    }
+    prog = npyflint_eval_parse(program, nin, &len, &depth);
+    if (prog == NULL) {
+        return NULL;
+    }
+    regs = PyMem_New(flint, depth*NPYFLINT_EVAL_BLOCK);
+    if (regs == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (i = 0; i < nin; i++) {
+        op[i] = (PyArrayObject*) PyArray_FROM_O(PyTuple_GET_ITEM(inputs, i));
+        if (op[i] == NULL) {
+            goto done;
+        }
+        op_dtypes[i] = PyArray_DescrFromType(NPY_FLINT);
+        op_flags[i] = NPY_ITER_READONLY | NPY_ITER_NBO | NPY_ITER_ALIGNED;
+    }
+    op_dtypes[nin] = PyArray_DescrFromType(NPY_FLINT);
+    if (out == Py_None) {
+        op_flags[nin] = NPY_ITER_WRITEONLY | NPY_ITER_ALLOCATE;
+    } else {
+        if (!PyArray_Check(out)) {
+            PyErr_SetString(PyExc_TypeError, "out must be an array");
+            goto done;
+        }
+        Py_INCREF(out);
+        op[nin] = (PyArrayObject*) out;
+        op_flags[nin] = NPY_ITER_WRITEONLY | NPY_ITER_NBO | NPY_ITER_ALIGNED |
+                        NPY_ITER_NO_BROADCAST;
+    }
+    iter = NpyIter_MultiNew(nin+1, op,
+                            NPY_ITER_EXTERNAL_LOOP | NPY_ITER_BUFFERED |
+                            NPY_ITER_GROWINNER | NPY_ITER_ZEROSIZE_OK |
+                            NPY_ITER_COPY_IF_OVERLAP,
+                            NPY_KEEPORDER, NPY_SAME_KIND_CASTING, op_flags, op_dtypes);
+    if (iter == NULL) {
+        goto done;
+    }
+    if (NpyIter_GetIterSize(iter) > 0) {
+        iternext = NpyIter_GetIterNext(iter, NULL);
+        if (iternext == NULL) {
+            goto done;
+        }
+        data = NpyIter_GetDataPtrArray(iter);
+        std = NpyIter_GetInnerStrideArray(iter);
+        size_ptr = NpyIter_GetInnerLoopSizePtr(iter);
+        needs_api = NpyIter_IterationNeedsAPI(iter);
+        if (!needs_api) {
+            NPY_BEGIN_THREADS;
+        }
+        do {
+            n = *size_ptr;
+            for (start = 0; start < n; start += NPYFLINT_EVAL_BLOCK) {
+                m = (n - start < NPYFLINT_EVAL_BLOCK) ? n - start : NPYFLINT_EVAL_BLOCK;
+                for (i = 0; i <= nin; i++) {
+                    block[i] = data[i] + start*std[i];
+                }
+                npyflint_eval_block(prog, len, regs, block, std, nin, m);
+                if (npyflint_stats_enabled) {
+                    npyflint_stats_add_widths(block[nin], std[nin], m, 0);
+                }
+            }
+        } while (iternext(iter));
+        NPY_END_THREADS;
+        if (needs_api && PyErr_Occurred()) {
+            goto done;
+        }
+    }
+    if (npyflint_stats_enabled) {
+        npyflint_stats_add(&npyflint_stats_loops, &npyflint_stats_evaluate,
+                           NpyIter_GetIterSize(iter), npyflint_stats_now() - t0);
+    }
+    ret = (PyObject*) NpyIter_GetOperandArray(iter)[nin];
+    Py_INCREF(ret);
+
+done:
+    if (iter != NULL) {
+        NpyIter_Deallocate(iter);
+    }
+    for (i = 0; i <= nin; i++) {
+        Py_XDECREF(op[i]);
+        Py_XDECREF(op_dtypes[i]);
+    }
+    PyMem_Free(regs);
+    PyMem_Free(prog);
+    return ret;
+}
+
+/// @brief Turn the performance counters on or off
+static PyObject* npyflint_set_stats(PyObject* NPY_UNUSED(self), PyObject* args) {
+    int enabled;
+    if (!PyArg_ParseTuple(args, "p:set_stats", &enabled)) {
+        return NULL;
+    }
+    npyflint_stats_enabled = enabled;
+    Py_RETURN_NONE;
+}
+
+/// @brief Zero the performance counters and the width histogram
+static PyObject* npyflint_reset_stats(PyObject* NPY_UNUSED(self),
+                                      PyObject* NPY_UNUSED(args)) {
+    npyflint_stats_entry* lists[2] = {npyflint_stats_loops, npyflint_stats_casts};
+    npyflint_stats_entry* s;
+    int i;
+    PyThread_acquire_lock(npyflint_stats_lock, WAIT_LOCK);
+    for (i=0; i<2; i++) {
+        for (s = lists[i]; s != NULL; s = s->next) {
+            s->calls = 0;
+            s->elements = 0;
+            s->seconds = 0.0;
+            s->used = 0;
+        }
+    }
+    npyflint_stats_loops = NULL;
+    npyflint_stats_casts = NULL;
+    for (i=0; i<NPYFLINT_STATS_BINS; i++) {
+        npyflint_stats_widths[i] = 0;
+    }
+    PyThread_release_lock(npyflint_stats_lock);
+    Py_RETURN_NONE;
+}
+
+/// @brief Get the performance counters
+/// @return A tuple with a list of (name, calls, elements, seconds) for the loops, a
+/// list of (name, calls, elements) for the casts, and the counts of the width histogram
+static PyObject* npyflint_get_stats(PyObject* NPY_UNUSED(self),
+                                    PyObject* NPY_UNUSED(args)) {
+    PyObject* loops = PyList_New(0);
+    PyObject* casts = PyList_New(0);
+    PyObject* widths = PyTuple_New(NPYFLINT_STATS_BINS);
+    PyObject* item;
+    PyObject* ret = NULL;
+    npyflint_stats_entry* s;
+    int i, ok = 1;
+    if (loops == NULL || casts == NULL || widths == NULL) {
+        goto done;
+    }
+    PyThread_acquire_lock(npyflint_stats_lock, WAIT_LOCK);
+    for (s = npyflint_stats_loops; s != NULL && ok; s = s->next) {
+        item = Py_BuildValue("(sLLd)", s->name, (long long) s->calls,
+                             (long long) s->elements, s->seconds);
+        ok = (item != NULL && PyList_Append(loops, item) == 0);
+        Py_XDECREF(item);
+    }
+    for (s = npyflint_stats_casts; s != NULL && ok; s = s->next) {
+        item = Py_BuildValue("(sLL)", s->name, (long long) s->calls,
+                             (long long) s->elements);
+        ok = (item != NULL && PyList_Append(casts, item) == 0);
+        Py_XDECREF(item);
+    }
+    for (i=0; i<NPYFLINT_STATS_BINS && ok; i++) {
+        item = PyLong_FromLongLong(npyflint_stats_widths[i]);
+        ok = (item != NULL);
+        PyTuple_SET_ITEM(widths, i, item);
+    }
+    PyThread_release_lock(npyflint_stats_lock);
+    if (ok) {
+        ret = Py_BuildValue("(OOO)", loops, casts, widths);
+    }
+
+done:
+    Py_XDECREF(loops);
+    Py_XDECREF(casts);
+    Py_XDECREF(widths);
+    return ret;
+}
+
+/// @brief The module level functions
+static PyMethodDef npyflint_module_methods[] = {
+    {"set_num_threads", npyflint_set_num_threads, METH_VARARGS,
+    "Set the number of threads used by the flint ufunc loops"},
+    {"get_num_threads", npyflint_get_num_threads, METH_NOARGS,
+    "Get the number of threads used by the flint ufunc loops"},
+    {"_after_fork", npyflint_after_fork, METH_NOARGS,
+    "Restart the worker threads in a forked child process"},
+    {"_component_view", npyflint_component_view, METH_VARARGS,
+    "Get a float64 view of the a, b, or v part of a flint array"},
+    {"_flint_view", npyflint_flint_view, METH_VARARGS,
+    "Get a flint array view of float64 views of the a, b, and v parts"},
+    {"from_bounds", (PyCFunction)(void(*)(void)) npyflint_from_bounds,
+    METH_VARARGS | METH_KEYWORDS,
+    "from_bounds(a, b, v=None)\n--\n\n"
+    "Make a flint array from arrays of lower bounds, upper bounds, and tracked values\n\n"
+    "The arrays are broadcast against each other and converted to float64. If v is\n"
+    "not given the tracked values are the midpoints of the intervals."},
+    {"_evaluate", npyflint_evaluate, METH_VARARGS,
+    "Run a fused expression program over broadcast flint arrays"},
+    {"set_stats", npyflint_set_stats, METH_VARARGS,
+    "Turn the flint performance counters on or off"},
+    {"reset_stats", npyflint_reset_stats, METH_NOARGS,
+    "Zero the flint performance counters"},
+    {"_get_stats", npyflint_get_stats, METH_NOARGS,
+    "Get the flint performance counters"},
+    {NULL, NULL, 0, NULL}
+};
 
 /// @brief utility type to find alignment for the flint object
 typedef struct {uint8_t c; flint f; } align_test;
@@ -1293,6 +4297,13 @@ static PyArray_ArrFuncs npyflint_arrfuncs;
 /// @brief A pointer to the Numpy array flint description type
 /// This gets fill in in the module initialization function below
 PyArray_Descr* npyflint_descr;
+/// @brief utility type to find alignment for the flint32 object
+typedef struct {uint8_t c; flint32 f; } align_test32;
+/// @brief The array methods for the flint32 dtype
+/// This gets fill in in the module initialization function below
+static PyArray_ArrFuncs npyflint32_arrfuncs;
+/// @brief The integer enumeration for the flint32 dtype in numpy
+static int NPY_FLINT32;
 
 // ###########################
 // ---- Module definition ----
@@ -1302,7 +4313,8 @@ static struct PyModuleDef moduledef = {
     PyModuleDef_HEAD_INIT,
     .m_name = "numpy_flint",
     .m_doc = "Rounded floating point intervals (flints)",
-    .m_size = -1
+    .m_size = -1,
+    .m_methods = npyflint_module_methods
 };
 
 /// @brief The module initialization function
@@ -1311,9 +4323,15 @@ PyMODINIT_FUNC PyInit_numpy_flint(void) {
     PyObject* numpy;
     PyObject* numpy_dict;
     PyArray_Descr* npyflint_descr;
+    PyArray_Descr* npyflint32_descr;
     PyArray_Descr* from_descr;
-    int arg_types[3];
-    static void* PyFlint_API[2];
+    const char* num_threads;
+    const char* stats;
+    long n;
+    int arg_types[4];
+    PyObject* fma_ufunc;
+    PyObject* eval_ops;
+    static void* PyFlint_API[PyFlint_API_size];
     PyObject* c_api_object;
     // Create the new module
     m = PyModule_Create(&moduledef);
@@ -1347,6 +4365,47 @@ PyMODINIT_FUNC PyInit_numpy_flint(void) {
         return NULL;
     }
 
+#ifdef FLINT_DIRECTED_ROUNDING
+    // Make sure the hardware honors the upward rounding mode before using it
+    int mode = fegetround();
+    if (fesetround(FE_UPWARD) != 0 || fegetround() != FE_UPWARD) {
+        fesetround(mode);
+        PyErr_SetString(PyExc_ImportError,
+            "flint was built with directed rounding, but the upward rounding mode is not supported.");
+        return NULL;
+    }
+    fesetround(mode);
+#endif
+
+    // Pick the vector kernels for this cpu
+    npyflint_simd_select();
+
+    // Create the thread pool, which only has the calling thread unless FLINT_NUM_THREADS
+    // asks for more
+    npyflint_pool_lock = PyThread_allocate_lock();
+    npyflint_job_lock = PyThread_allocate_lock();
+    if (npyflint_pool_lock == NULL || npyflint_job_lock == NULL) {
+        Py_DECREF(m);
+        PyErr_SetString(PyExc_SystemError, "Could not allocate the thread pool locks.");
+        return NULL;
+    }
+    num_threads = getenv("FLINT_NUM_THREADS");
+    if (num_threads != NULL) {
+        n = strtol(num_threads, NULL, 10);
+        if (n > 1) {
+            npyflint_set_threads(n < NPYFLINT_MAX_THREADS ? (int) n : NPYFLINT_MAX_THREADS);
+        }
+    }
+    // The performance counters are off unless FLINT_STATS turns them on
+    npyflint_stats_lock = PyThread_allocate_lock();
+    if (npyflint_stats_lock == NULL) {
+        Py_DECREF(m);
+        PyErr_SetString(PyExc_SystemError, "Could not allocate the performance counter lock.");
+        return NULL;
+    }
+    stats = getenv("FLINT_STATS");
+    npyflint_stats_enabled = (stats != NULL && strtol(stats, NULL, 10) > 0);
+
     // Finalize the PyFlint type by having it inherit from numpy arraytype
     PyFlint_Type.tp_base = &PyGenericArrType_Type;
     // Initialize flint type
@@ -1357,6 +4416,14 @@ PyMODINIT_FUNC PyInit_numpy_flint(void) {
     }
     Py_INCREF(&PyFlint_Type);
     PyFlint_Type_Ptr = &PyFlint_Type;
+    // The flint32 scalars are a subclass of flints
+    PyFlint32_Type.tp_base = &PyFlint_Type;
+    if (PyType_Ready(&PyFlint32_Type) < 0) {
+        PyErr_Print();
+        PyErr_SetString(PyExc_SystemError, "Could not initialize flint32 type.");
+        return NULL;
+    }
+    Py_INCREF(&PyFlint32_Type);
 
     // Initialize the numpy data-type extension of the python type
     // Register standard arrayfuncs for numpy-flint
@@ -1366,6 +4433,12 @@ PyMODINIT_FUNC PyInit_numpy_flint(void) {
     npyflint_arrfuncs.copyswapn = (PyArray_CopySwapNFunc*) npyflint_copyswapn; // PyArray_CopySwapNFunc *copyswapn;
     npyflint_arrfuncs.copyswap = (PyArray_CopySwapFunc*) npyflint_copyswap; // PyArray_CopySwapFunc *copyswap;
     npyflint_arrfuncs.compare = (PyArray_CompareFunc*) npyflint_compare; // PyArray_CompareFunc *compare;
+    npyflint_arrfuncs.sort[NPY_QUICKSORT] = npyflint_quicksort; // PyArray_SortFunc *sort[NPY_NSORTS];
+    npyflint_arrfuncs.sort[NPY_HEAPSORT] = npyflint_heapsort;
+    npyflint_arrfuncs.sort[NPY_MERGESORT] = npyflint_mergesort;
+    npyflint_arrfuncs.argsort[NPY_QUICKSORT] = npyflint_aquicksort; // PyArray_ArgSortFunc *argsort[NPY_NSORTS];
+    npyflint_arrfuncs.argsort[NPY_HEAPSORT] = npyflint_aheapsort;
+    npyflint_arrfuncs.argsort[NPY_MERGESORT] = npyflint_amergesort;
     npyflint_arrfuncs.argmax = (PyArray_ArgFunc*) npyflint_argmax; // PyArray_ArgFunc *argmax;
     npyflint_arrfuncs.argmin = (PyArray_ArgFunc*) npyflint_argmin;
     npyflint_arrfuncs.dotfunc = (PyArray_DotFunc*) npyflint_dotfunc; // PyArray_DotFunc *dotfunc;
@@ -1378,7 +4451,9 @@ PyMODINIT_FUNC PyInit_numpy_flint(void) {
     npyflint_descr->kind = 'V'; // char kind;
     npyflint_descr->type = 'r'; // char type;
     npyflint_descr->byteorder = '='; // char byteorder;
-    npyflint_descr->flags = NPY_NEEDS_PYAPI | NPY_USE_GETITEM | NPY_USE_SETITEM; // char flags;
+    // Only getitem and setitem use the python api, so no NPY_NEEDS_PYAPI. That lets NumPy
+    // release the GIL for the ufunc loops, casts and copies.
+    npyflint_descr->flags = NPY_USE_GETITEM | NPY_USE_SETITEM; // char flags;
     npyflint_descr->type_num = 0; // int type_num;
     npyflint_descr->elsize = sizeof(flint); // int elsize;
     npyflint_descr->alignment = offsetof(align_test, f); // int alignment;
@@ -1461,11 +4536,98 @@ PyMODINIT_FUNC PyInit_numpy_flint(void) {
     // REGISTER_COERSION_FROM(NPY_HALF, npy_half)
     REGISTER_COERSION_FROM(NPY_FLOAT, npy_float)
     REGISTER_COERSION_FROM(NPY_DOUBLE, npy_double)
+
+    // Initialize the numpy data-type for the flint32 in the same way
+    PyArray_InitArrFuncs(&npyflint32_arrfuncs);
+    npyflint32_arrfuncs.getitem = (PyArray_GetItemFunc*) npyflint32_getitem;
+    npyflint32_arrfuncs.setitem = (PyArray_SetItemFunc*) npyflint32_setitem;
+    npyflint32_arrfuncs.copyswapn = (PyArray_CopySwapNFunc*) npyflint32_copyswapn;
+    npyflint32_arrfuncs.copyswap = (PyArray_CopySwapFunc*) npyflint32_copyswap;
+    npyflint32_arrfuncs.compare = (PyArray_CompareFunc*) npyflint32_compare;
+    npyflint32_arrfuncs.argmax = (PyArray_ArgFunc*) npyflint32_argmax;
+    npyflint32_arrfuncs.argmin = (PyArray_ArgFunc*) npyflint32_argmin;
+    npyflint32_arrfuncs.nonzero = (PyArray_NonzeroFunc*) npyflint32_nonzero;
+    npyflint32_arrfuncs.fillwithscalar = (PyArray_FillWithScalarFunc*) npyflint32_fillwithscalar;
+    npyflint32_descr = PyObject_New(PyArray_Descr, &PyArrayDescr_Type);
+    npyflint32_descr->typeobj = &PyFlint32_Type;
+    npyflint32_descr->kind = 'V';
+    npyflint32_descr->type = 'R';
+    npyflint32_descr->byteorder = '=';
+    npyflint32_descr->flags = NPY_USE_GETITEM | NPY_USE_SETITEM;
+    npyflint32_descr->type_num = 0;
+    npyflint32_descr->elsize = sizeof(flint32);
+    npyflint32_descr->alignment = offsetof(align_test32, f);
+    npyflint32_descr->subarray = NULL;
+    npyflint32_descr->fields = NULL;
+    npyflint32_descr->names = NULL;
+    npyflint32_descr->f = &npyflint32_arrfuncs;
+    npyflint32_descr->metadata = NULL;
+    npyflint32_descr->c_metadata = NULL;
+
+    NPY_FLINT32 = PyArray_RegisterDataType(npyflint32_descr);
+    if (NPY_FLINT32 < 0) {
+        PyErr_Print();
+        PyErr_SetString(PyExc_SystemError, "Could not register flint32 type with numpy.");
+        return NULL;
+    }
+
+    // Register the casts between flint32 and flint, widening is exact so it is safe
+    PyArray_RegisterCastFunc(npyflint32_descr, NPY_FLINT, npycast_flint32_flint);
+    PyArray_RegisterCastFunc(npyflint_descr, NPY_FLINT32, npycast_flint_flint32);
+    PyArray_RegisterCanCast(npyflint32_descr, NPY_FLINT, NPY_NOSCALAR);
+    // Register casting from flint32 to the real types
+    #define REGISTER_CAST_FROM_FLINT32(typenum, type) \
+    PyArray_RegisterCastFunc(npyflint32_descr, typenum, npycast_flint32_##type);
+    REGISTER_CAST_FROM_FLINT32(NPY_BOOL, npy_bool)
+    REGISTER_CAST_FROM_FLINT32(NPY_BYTE, npy_byte)
+    REGISTER_CAST_FROM_FLINT32(NPY_SHORT, npy_short)
+    REGISTER_CAST_FROM_FLINT32(NPY_INT, npy_int)
+    REGISTER_CAST_FROM_FLINT32(NPY_LONG, npy_long)
+    REGISTER_CAST_FROM_FLINT32(NPY_LONGLONG, npy_longlong)
+    REGISTER_CAST_FROM_FLINT32(NPY_UBYTE, npy_ubyte)
+    REGISTER_CAST_FROM_FLINT32(NPY_USHORT, npy_ushort)
+    REGISTER_CAST_FROM_FLINT32(NPY_UINT, npy_uint)
+    REGISTER_CAST_FROM_FLINT32(NPY_ULONG, npy_ulong)
+    REGISTER_CAST_FROM_FLINT32(NPY_ULONGLONG, npy_ulonglong)
+    REGISTER_CAST_FROM_FLINT32(NPY_FLOAT, npy_float)
+    REGISTER_CAST_FROM_FLINT32(NPY_DOUBLE, npy_double)
+    REGISTER_CAST_FROM_FLINT32(NPY_LONGDOUBLE, npy_longdouble)
+    // Register casting from the real types to flint32
+    #define REGISTER_CAST_TO_FLINT32(typenum, type) \
+    from_descr = PyArray_DescrFromType(typenum); \
+    PyArray_RegisterCastFunc(from_descr, NPY_FLINT32, npycast_##type##_flint32); \
+    Py_DECREF(from_descr);
+    REGISTER_CAST_TO_FLINT32(NPY_BOOL, npy_bool)
+    REGISTER_CAST_TO_FLINT32(NPY_BYTE, npy_byte)
+    REGISTER_CAST_TO_FLINT32(NPY_SHORT, npy_short)
+    REGISTER_CAST_TO_FLINT32(NPY_INT, npy_int)
+    REGISTER_CAST_TO_FLINT32(NPY_LONG, npy_long)
+    REGISTER_CAST_TO_FLINT32(NPY_LONGLONG, npy_longlong)
+    REGISTER_CAST_TO_FLINT32(NPY_UBYTE, npy_ubyte)
+    REGISTER_CAST_TO_FLINT32(NPY_USHORT, npy_ushort)
+    REGISTER_CAST_TO_FLINT32(NPY_UINT, npy_uint)
+    REGISTER_CAST_TO_FLINT32(NPY_ULONG, npy_ulong)
+    REGISTER_CAST_TO_FLINT32(NPY_ULONGLONG, npy_ulonglong)
+    REGISTER_CAST_TO_FLINT32(NPY_FLOAT, npy_float)
+    REGISTER_CAST_TO_FLINT32(NPY_DOUBLE, npy_double)
+    REGISTER_CAST_TO_FLINT32(NPY_LONGDOUBLE, npy_longdouble)
+    // Only the types that fit in a float can be coerced into a flint32
+    #define REGISTER_COERSION_FROM32(typenum) \
+    from_descr = PyArray_DescrFromType(typenum); \
+    PyArray_RegisterCanCast(from_descr, NPY_FLINT32, NPY_NOSCALAR); \
+    Py_DECREF(from_descr);
+    REGISTER_COERSION_FROM32(NPY_BOOL)
+    REGISTER_COERSION_FROM32(NPY_BYTE)
+    REGISTER_COERSION_FROM32(NPY_SHORT)
+    REGISTER_COERSION_FROM32(NPY_UBYTE)
+    REGISTER_COERSION_FROM32(NPY_USHORT)
+    REGISTER_COERSION_FROM32(NPY_FLOAT)
     // Small macro for registering methods that match name with existing numpy
     // functions
     #define REGISTER_UFUNC(npname, flname) \
     PyUFunc_RegisterLoopForType((PyUFuncObject*) PyDict_GetItemString(numpy_dict, #npname), \
-                                NPY_FLINT, npyflint_ufunc_##flname, arg_types, NULL);
+                                NPY_FLINT, npyflint_ufunc_parallel, arg_types, \
+                                &npyflint_parallel_##flname);
     // These are sorted by number and types of arguments and return value
     // flint -> bool
     arg_types[0] = NPY_FLINT;
@@ -1479,6 +4641,7 @@ PyMODINIT_FUNC PyInit_numpy_flint(void) {
     REGISTER_UFUNC(absolute, absolute)
     REGISTER_UFUNC(negative, negative)
     REGISTER_UFUNC(positive, positive)
+    REGISTER_UFUNC(square, square)
     REGISTER_UFUNC(sqrt, sqrt)
     REGISTER_UFUNC(cbrt, cbrt)
     REGISTER_UFUNC(exp, exp)
@@ -1500,6 +4663,10 @@ PyMODINIT_FUNC PyInit_numpy_flint(void) {
     REGISTER_UFUNC(arcsinh, asinh)
     REGISTER_UFUNC(arccosh, acosh)
     REGISTER_UFUNC(arctanh, atanh)
+    REGISTER_UFUNC(floor, floor)
+    REGISTER_UFUNC(ceil, ceil)
+    REGISTER_UFUNC(trunc, trunc)
+    REGISTER_UFUNC(rint, rint)
     // flint, flint -> bool
     arg_types[0] = NPY_FLINT;
     arg_types[1] = NPY_FLINT;
@@ -1510,6 +4677,26 @@ PyMODINIT_FUNC PyInit_numpy_flint(void) {
     REGISTER_UFUNC(less_equal, le)
     REGISTER_UFUNC(greater, gt)
     REGISTER_UFUNC(greater_equal, ge)
+    // flint, double -> bool
+    arg_types[0] = NPY_FLINT;
+    arg_types[1] = NPY_DOUBLE;
+    arg_types[2] = NPY_BOOL;
+    REGISTER_UFUNC(equal, eq_mixed)
+    REGISTER_UFUNC(not_equal, ne_mixed)
+    REGISTER_UFUNC(less, lt_mixed)
+    REGISTER_UFUNC(less_equal, le_mixed)
+    REGISTER_UFUNC(greater, gt_mixed)
+    REGISTER_UFUNC(greater_equal, ge_mixed)
+    // double, flint -> bool
+    arg_types[0] = NPY_DOUBLE;
+    arg_types[1] = NPY_FLINT;
+    arg_types[2] = NPY_BOOL;
+    REGISTER_UFUNC(equal, mixed_eq)
+    REGISTER_UFUNC(not_equal, mixed_ne)
+    REGISTER_UFUNC(less, mixed_lt)
+    REGISTER_UFUNC(less_equal, mixed_le)
+    REGISTER_UFUNC(greater, mixed_gt)
+    REGISTER_UFUNC(greater_equal, mixed_ge)
     // flint, flint -> flint
     arg_types[0] = NPY_FLINT;
     arg_types[1] = NPY_FLINT;
@@ -1519,9 +4706,133 @@ PyMODINIT_FUNC PyInit_numpy_flint(void) {
     REGISTER_UFUNC(multiply, multiply)
     REGISTER_UFUNC(true_divide, divide)
     REGISTER_UFUNC(power, power)
+    REGISTER_UFUNC(minimum, minimum)
+    REGISTER_UFUNC(maximum, maximum)
+    REGISTER_UFUNC(fmin, fmin)
+    REGISTER_UFUNC(fmax, fmax)
     REGISTER_UFUNC(hypot, hypot)
     REGISTER_UFUNC(arctan2, atan2)
-    // Finally register the new type with the module
+    REGISTER_UFUNC(fmod, fmod)
+    REGISTER_UFUNC(remainder, remainder)
+    REGISTER_UFUNC(floor_divide, floor_divide)
+    // flint -> flint, flint
+    REGISTER_UFUNC(modf, modf)
+    // (m,n),(n,p) -> (m,p)
+    PyUFunc_RegisterLoopForType((PyUFuncObject*) PyDict_GetItemString(numpy_dict, "matmul"),
+                                NPY_FLINT, npyflint_ufunc_matmul, arg_types, NULL);
+    // flint, flint, flint -> flint
+    // NumPy has no fused multiply-add, so it is a new ufunc in the flint module
+    arg_types[3] = NPY_FLINT;
+    fma_ufunc = PyUFunc_FromFuncAndData(
+        NULL, NULL, NULL, 0, 3, 1, PyUFunc_None, "fma",
+        "The fused multiply-add x*y + z, rounding each boundary only once.", 0);
+    if (fma_ufunc == NULL ||
+        PyUFunc_RegisterLoopForType((PyUFuncObject*) fma_ufunc, NPY_FLINT,
+                                    npyflint_ufunc_parallel, arg_types,
+                                    &npyflint_parallel_fma) < 0 ||
+        PyModule_AddObject(m, "fma", fma_ufunc) < 0) {
+        Py_XDECREF(fma_ufunc);
+        Py_DECREF(m);
+        PyErr_Print();
+        PyErr_SetString(PyExc_SystemError, "Could not add the numpy_flint.fma ufunc.");
+        return NULL;
+    }
+    // flint, int64 -> flint
+    // NumPy tries this before the flint, flint loop since int64 casts safely to flint
+    arg_types[0] = NPY_FLINT;
+    arg_types[1] = NPY_INT64;
+    arg_types[2] = NPY_FLINT;
+    REGISTER_UFUNC(power, power_int)
+    // flint, double -> flint
+    arg_types[0] = NPY_FLINT;
+    arg_types[1] = NPY_DOUBLE;
+    arg_types[2] = NPY_FLINT;
+    REGISTER_UFUNC(add, add_mixed)
+    REGISTER_UFUNC(subtract, subtract_mixed)
+    REGISTER_UFUNC(multiply, multiply_mixed)
+    REGISTER_UFUNC(true_divide, divide_mixed)
+    // double, flint -> flint
+    arg_types[0] = NPY_DOUBLE;
+    arg_types[1] = NPY_FLINT;
+    arg_types[2] = NPY_FLINT;
+    REGISTER_UFUNC(add, mixed_add)
+    REGISTER_UFUNC(subtract, mixed_subtract)
+    REGISTER_UFUNC(multiply, mixed_multiply)
+    REGISTER_UFUNC(true_divide, mixed_divide)
+    // The flint32 loops, any mix with flints uses the flint loops
+    #define REGISTER_UFUNC32(npname, flname) \
+    PyUFunc_RegisterLoopForType((PyUFuncObject*) PyDict_GetItemString(numpy_dict, #npname), \
+                                NPY_FLINT32, npyflint_ufunc_parallel, arg_types, \
+                                &npyflint_parallel_f32_##flname);
+    // flint32 -> bool
+    arg_types[0] = NPY_FLINT32;
+    arg_types[1] = NPY_BOOL;
+    REGISTER_UFUNC32(isnan, isnan)
+    REGISTER_UFUNC32(isinf, isinf)
+    REGISTER_UFUNC32(isfinite, isfinite)
+    // flint32 -> flint32
+    arg_types[0] = NPY_FLINT32;
+    arg_types[1] = NPY_FLINT32;
+    REGISTER_UFUNC32(absolute, absolute)
+    REGISTER_UFUNC32(negative, negative)
+    REGISTER_UFUNC32(positive, positive)
+    REGISTER_UFUNC32(square, square)
+    REGISTER_UFUNC32(sqrt, sqrt)
+    REGISTER_UFUNC32(cbrt, cbrt)
+    REGISTER_UFUNC32(exp, exp)
+    REGISTER_UFUNC32(exp2, exp2)
+    REGISTER_UFUNC32(expm1, expm1)
+    REGISTER_UFUNC32(log, log)
+    REGISTER_UFUNC32(log10, log10)
+    REGISTER_UFUNC32(log2, log2)
+    REGISTER_UFUNC32(log1p, log1p)
+    REGISTER_UFUNC32(sin, sin)
+    REGISTER_UFUNC32(cos, cos)
+    REGISTER_UFUNC32(tan, tan)
+    REGISTER_UFUNC32(arcsin, asin)
+    REGISTER_UFUNC32(arccos, acos)
+    REGISTER_UFUNC32(arctan, atan)
+    REGISTER_UFUNC32(sinh, sinh)
+    REGISTER_UFUNC32(cosh, cosh)
+    REGISTER_UFUNC32(tanh, tanh)
+    REGISTER_UFUNC32(arcsinh, asinh)
+    REGISTER_UFUNC32(arccosh, acosh)
+    REGISTER_UFUNC32(arctanh, atanh)
+    REGISTER_UFUNC32(floor, floor)
+    REGISTER_UFUNC32(ceil, ceil)
+    REGISTER_UFUNC32(trunc, trunc)
+    REGISTER_UFUNC32(rint, rint)
+    // flint32, flint32 -> bool
+    arg_types[0] = NPY_FLINT32;
+    arg_types[1] = NPY_FLINT32;
+    arg_types[2] = NPY_BOOL;
+    REGISTER_UFUNC32(equal, eq)
+    REGISTER_UFUNC32(not_equal, ne)
+    REGISTER_UFUNC32(less, lt)
+    REGISTER_UFUNC32(less_equal, le)
+    REGISTER_UFUNC32(greater, gt)
+    REGISTER_UFUNC32(greater_equal, ge)
+    // flint32, flint32 -> flint32
+    arg_types[0] = NPY_FLINT32;
+    arg_types[1] = NPY_FLINT32;
+    arg_types[2] = NPY_FLINT32;
+    REGISTER_UFUNC32(add, add)
+    REGISTER_UFUNC32(subtract, subtract)
+    REGISTER_UFUNC32(multiply, multiply)
+    REGISTER_UFUNC32(true_divide, divide)
+    REGISTER_UFUNC32(power, power)
+    REGISTER_UFUNC32(minimum, minimum)
+    REGISTER_UFUNC32(maximum, maximum)
+    REGISTER_UFUNC32(fmin, fmin)
+    REGISTER_UFUNC32(fmax, fmax)
+    REGISTER_UFUNC32(hypot, hypot)
+    REGISTER_UFUNC32(arctan2, atan2)
+    REGISTER_UFUNC32(fmod, fmod)
+    REGISTER_UFUNC32(remainder, remainder)
+    REGISTER_UFUNC32(floor_divide, floor_divide)
+    // flint32 -> flint32, flint32
+    REGISTER_UFUNC32(modf, modf)
+    // Finally register the new types with the module
     if (PyModule_AddObject(m, "flint", (PyObject *) &PyFlint_Type) < 0) {
         Py_DECREF(&PyFlint_Type);
         Py_DECREF(m);
@@ -1529,9 +4840,53 @@ PyMODINIT_FUNC PyInit_numpy_flint(void) {
         PyErr_SetString(PyExc_SystemError, "Could not add numpy_flint.flint type to module flint.");
         return NULL;
     }
+    if (PyModule_AddObject(m, "flint32", (PyObject *) &PyFlint32_Type) < 0) {
+        Py_DECREF(&PyFlint32_Type);
+        Py_DECREF(m);
+        PyErr_Print();
+        PyErr_SetString(PyExc_SystemError, "Could not add numpy_flint.flint32 type to module flint.");
+        return NULL;
+    }
+    // Record how the interval boundaries are rounded
+#ifdef FLINT_DIRECTED_ROUNDING
+    if (PyModule_AddStringConstant(m, "rounding_mode", "directed") < 0) {
+#else
+    if (PyModule_AddStringConstant(m, "rounding_mode", "nextafter") < 0) {
+#endif
+        Py_DECREF(m);
+        PyErr_Print();
+        PyErr_SetString(PyExc_SystemError, "Could not add numpy_flint.rounding_mode to flint module.");
+        return NULL;
+    }
+    // Record which instruction set the vector kernels use
+    if (PyModule_AddStringConstant(m, "simd", npyflint_simd->isa) < 0) {
+        Py_DECREF(m);
+        PyErr_Print();
+        PyErr_SetString(PyExc_SystemError, "Could not add numpy_flint.simd to flint module.");
+        return NULL;
+    }
+    // Record the operations of the fused expression programs
+    eval_ops = PyTuple_New(NPYFLINT_EVAL_NUM_OPS);
+    for (n = 0; eval_ops != NULL && n < NPYFLINT_EVAL_NUM_OPS; n++) {
+        PyTuple_SET_ITEM(eval_ops, n, PyUnicode_FromString(npyflint_eval_names[n]));
+    }
+    if (eval_ops == NULL || PyErr_Occurred() ||
+        PyModule_AddObject(m, "_evaluate_ops", eval_ops) < 0) {
+        Py_XDECREF(eval_ops);
+        Py_DECREF(m);
+        PyErr_Print();
+        PyErr_SetString(PyExc_SystemError, "Could not add numpy_flint._evaluate_ops to flint module.");
+        return NULL;
+    }
     // Register PyFlint_Type and NPY_FLINT with the c api
-    PyFlint_API[0] = (void*) get_pyflint_type_ptr;
-    PyFlint_API[1] = (void*) get_npy_flint;
+    PyFlint_API[PyFlint_API_get_pyflint_type_ptr] = (void*) get_pyflint_type_ptr;
+    PyFlint_API[PyFlint_API_get_npy_flint] = (void*) get_npy_flint;
+    PyFlint_API[PyFlint_API_from_flint] = (void*) pyflint_from_flint;
+    #define REGISTER_BATCH(name) \
+    PyFlint_API[PyFlint_API_##name##_n] = (void*) flint_##name##_n; \
+    PyFlint_API[PyFlint_API_##name##_strided] = (void*) flint_##name##_strided;
+    FLINT_BATCH_BINARY_FUNCS(REGISTER_BATCH)
+    FLINT_BATCH_UNARY_FUNCS(REGISTER_BATCH)
     c_api_object = PyCapsule_New((void*) PyFlint_API, "flint.numpy_flint.c_api", NULL);
     if (c_api_object == NULL) {
         Py_XDECREF(c_api_object);
@@ -26,6 +26,7 @@ extern "C" {
 #endif
 
 #include <Python.h>
+#include <stddef.h>
 #include "flint.h"
 
 /**
@@ -54,8 +55,59 @@ static PyTypeObject* PyFlint_Type_Ptr;
  */
 static int NPY_FLINT;
 
+/**
+ * Batch functions
+ * ---------------
+ *
+ * The batch functions apply a flint function to every element of an array. They use
+ * the same loops as the NumPy ufuncs, so they get the vector kernels picked for the
+ * cpu when the module was imported, and long arrays are split across the threads set
+ * with ``flint.set_num_threads``. Each function comes in two versions:
+ *
+ * .. c:function:: void flint_FUNCNAME_n(const flint* x, flint* z, size_t n)
+ *
+ *     for contiguous arrays of n flints, and
+ *
+ * .. c:function:: void flint_FUNCNAME_strided(const flint* x, ptrdiff_t sx, flint* z, ptrdiff_t sz, size_t n)
+ *
+ *     for arrays whose elements are sx and sz bytes apart. The binary functions take a
+ *     second input array y (and stride sy) after x. The output can be the same array as
+ *     one of the inputs.
+ */
+#define FLINT_BATCH_BINARY_FUNCS(X) \
+    X(add) X(subtract) X(multiply) X(divide) X(power) X(hypot) X(atan2)
+#define FLINT_BATCH_UNARY_FUNCS(X) \
+    X(negative) X(absolute) X(sqrt) X(cbrt) X(exp) X(exp2) X(expm1) X(log) X(log10) \
+    X(log2) X(log1p) X(sin) X(cos) X(tan) X(asin) X(acos) X(atan) X(sinh) X(cosh) \
+    X(tanh) X(asinh) X(acosh) X(atanh)
+
+typedef void flint_batch_unary_func(const flint* x, flint* z, size_t n);
+typedef void flint_batch_unary_strided_func(const flint* x, ptrdiff_t sx,
+                                            flint* z, ptrdiff_t sz, size_t n);
+typedef void flint_batch_binary_func(const flint* x, const flint* y, flint* z, size_t n);
+typedef void flint_batch_binary_strided_func(const flint* x, ptrdiff_t sx,
+                                             const flint* y, ptrdiff_t sy,
+                                             flint* z, ptrdiff_t sz, size_t n);
+
+/**
+ * The index of each function pointer in the c api capsule
+ */
+enum {
+    PyFlint_API_get_pyflint_type_ptr,
+    PyFlint_API_get_npy_flint,
+    PyFlint_API_from_flint,
+#define FLINT_BATCH_SLOTS(name) PyFlint_API_##name##_n, PyFlint_API_##name##_strided,
+    FLINT_BATCH_BINARY_FUNCS(FLINT_BATCH_SLOTS)
+    FLINT_BATCH_UNARY_FUNCS(FLINT_BATCH_SLOTS)
+#undef FLINT_BATCH_SLOTS
+    PyFlint_API_size
+};
+
 #ifdef NUMPY_FLINT_MODULE // If header file accessed as part of numpy-flint project
 
+// Create a new PyFlint, defined in numpy_flint.c
+static PyObject* pyflint_from_flint(flint f);
+
 // Get the flint PyTypeObject
 static PyTypeObject* get_pyflint_type_ptr() {
     return &PyFlint_Type;
@@ -68,11 +120,34 @@ static int get_npy_flint() {
 
 #else // If header file is used outside of the numpy-flint project
 
-#define get_pyflint_type_ptr (*(PyTypeObject* (*)()) PyFlint_API[0])
-#define get_npy_flint (*(int (*)()) PyFlint_API[1])
+#define get_pyflint_type_ptr (*(PyTypeObject* (*)()) PyFlint_API[PyFlint_API_get_pyflint_type_ptr])
+#define get_npy_flint (*(int (*)()) PyFlint_API[PyFlint_API_get_npy_flint])
+#define pyflint_from_flint (*(PyObject* (*)(flint)) PyFlint_API[PyFlint_API_from_flint])
 
 static void** PyFlint_API;
 
+#define FLINT_BATCH_BINARY_IMPORT(name) \
+static inline void flint_##name##_n(const flint* x, const flint* y, flint* z, size_t n) { \
+    ((flint_batch_binary_func*) PyFlint_API[PyFlint_API_##name##_n])(x, y, z, n); \
+} \
+static inline void flint_##name##_strided(const flint* x, ptrdiff_t sx, \
+                                          const flint* y, ptrdiff_t sy, \
+                                          flint* z, ptrdiff_t sz, size_t n) { \
+    ((flint_batch_binary_strided_func*) PyFlint_API[PyFlint_API_##name##_strided])( \
+        x, sx, y, sy, z, sz, n); \
+}
+#define FLINT_BATCH_UNARY_IMPORT(name) \
+static inline void flint_##name##_n(const flint* x, flint* z, size_t n) { \
+    ((flint_batch_unary_func*) PyFlint_API[PyFlint_API_##name##_n])(x, z, n); \
+} \
+static inline void flint_##name##_strided(const flint* x, ptrdiff_t sx, \
+                                          flint* z, ptrdiff_t sz, size_t n) { \
+    ((flint_batch_unary_strided_func*) PyFlint_API[PyFlint_API_##name##_strided])( \
+        x, sx, z, sz, n); \
+}
+FLINT_BATCH_BINARY_FUNCS(FLINT_BATCH_BINARY_IMPORT)
+FLINT_BATCH_UNARY_FUNCS(FLINT_BATCH_UNARY_IMPORT)
+
 /**
  * Import the c api for numpy-flint python module
  * 
@@ -97,7 +172,7 @@ static int import_flint(void) {
  * :return: 1 if the object is a flint, 0 otherwise
  */
 static inline int PyFlint_Check(PyObject* ob) {
-    return PyObject_IsInstance(ob, (PyObject*) PyFlint_Type_Ptr);
+    return PyObject_TypeCheck(ob, PyFlint_Type_Ptr);
 }
 
 /**
@@ -107,11 +182,7 @@ static inline int PyFlint_Check(PyObject* ob) {
  * :return: A new PyFlint object that contains a copy of f
  */
 static inline PyObject* PyFlint_FromFlint(flint f) {
-    PyFlint* p = (PyFlint*) PyFlint_Type.tp_alloc(PyFlint_Type_Ptr, 0);
-    if (p) {
-        p->obval = f;
-    }
-    return (PyObject*) p;
+    return pyflint_from_flint(f);
 }
 
 /**
@@ -13,10 +13,22 @@
 #
 # You should have received a copy of the GNU General Public License along with
 # numpy-flint. If not, see <https://www.gnu.org/licenses/>.
+import copyreg
+import ctypes
+import io
+import os
+import pickle
+import shutil
+import subprocess
+import sys
+import tempfile
 import unittest
+from concurrent.futures import ThreadPoolExecutor
+from fractions import Fraction
 
 import numpy as np
-from flint import flint
+import flint as flint_module
+from flint import flint, flint32
 
 class TestInit(unittest.TestCase):
     """Test for the initialization and internal structure of the flint objects"""
@@ -58,6 +70,39 @@ class TestInit(unittest.TestCase):
         self.assertEqual(x.b, y.b)
         self.assertEqual(x.v, y.v)
 
+    def test_init_errors(self):
+        """Validate the constructor argument checks"""
+        class SubFlint(flint):
+            pass
+        self.assertIsInstance(SubFlint(1.5), SubFlint)
+        self.assertEqual(SubFlint(1.5).v, 1.5)
+        self.assertEqual(flint(10**30).v, 1e30)
+        with self.assertRaises(TypeError):
+            flint()
+        with self.assertRaises(TypeError):
+            flint(1, 2)
+        with self.assertRaises(TypeError):
+            flint(x=1)
+        with self.assertRaises(TypeError):
+            flint('a')
+
+    def test_reused_objects(self):
+        """Validate that flints reused from the free list start fresh"""
+        class SubFlint(flint):
+            pass
+        xs = [flint(i) for i in range(500)]
+        del xs
+        ys = [flint(i) + 1 for i in range(500)]
+        for i, y in enumerate(ys):
+            self.assertIsInstance(y, flint)
+            self.assertEqual(y.v, i + 1)
+        s = SubFlint(2)
+        self.assertIsInstance(s, SubFlint)
+        self.assertEqual(s.v, 2)
+        del s
+        z = flint(0)
+        self.assertEqual(z.interval, (0, 0))
+
 
 class TestProperties(unittest.TestCase):
     """Test for the properties of the flint objects"""
@@ -113,14 +158,45 @@ class TestState:
         x.interval = 1,2
         r = x.__reduce__()
         assert isinstance(r, tuple)
-        assert len(r) == 2
-        assert isinstance(r[0], type)
-        assert r[0] == type(x)
-        assert isinstance(r[1], tuple)
-        assert len(r[1]) == 3
-        assert r[1][0] == x.a
-        assert r[1][1] == x.b
-        assert r[1][2] == x.v
+        assert len(r) == 3
+        assert r[0] is copyreg.__newobj__
+        assert r[1] == (type(x),)
+        assert isinstance(r[2], tuple)
+        assert len(r[2]) == 3
+        assert r[2][0] == x.a
+        assert r[2][1] == x.b
+        assert r[2][2] == x.v
+
+    def test_pickle(self):
+        x = flint(1.5)
+        x.interval = 1,2
+        y = pickle.loads(pickle.dumps(x))
+        assert type(y) is flint
+        assert y.interval == (1, 2)
+        assert y.v == 1.5
+        z = flint(1, 2, 1.5)
+        assert z.interval == (1, 2) and z.v == 1.5
+        for a, b, v in [(2, 1, 1.5), (1, 2, 3), (1, 2, 0.5)]:
+            try:
+                flint(a, b, v)
+                assert False
+            except ValueError:
+                pass
+        assert np.isnan(flint(np.nan, np.nan, np.nan))
+        y = pickle.loads(pickle.dumps(flint32(0.1)))
+        assert type(y) is flint32 and y.interval == flint32(0.1).interval
+
+    def test_pickle_setter(self):
+        x = flint(0)
+        x.interval = 1, 2, 3
+        y = flint(0)
+        y.interval = 1.7e308, 1.7e308
+        for f in [x, y]:
+            for protocol in range(pickle.HIGHEST_PROTOCOL+1):
+                z = pickle.loads(pickle.dumps(f, protocol=protocol))
+                assert type(z) is flint
+                assert z.interval == f.interval
+                assert z.v == f.v
 
 
 class TestFloatSpecialValues(unittest.TestCase):
@@ -272,6 +348,50 @@ class TestArithmetic(unittest.TestCase):
         self.assertTrue(y.eps > 0)
         self.assertEqual(y, 2)
 
+    def test_number_operand_conversion(self):
+        """Validate python and numpy number operands convert like the constructor"""
+        x = flint(1.5)
+        for n in [3, 10000000000000000, 2**70, np.int64(3), np.int32(-7), True, np.float32(0.5),
+                  0.1, -2.5, np.float64(0.3)]:
+            y = x + n
+            z = x + flint(n)
+            self.assertEqual(y.a, z.a)
+            self.assertEqual(y.b, z.b)
+            self.assertEqual(y.v, z.v)
+            y = n * x
+            z = flint(n) * x
+            self.assertEqual(y.a, z.a)
+            self.assertEqual(y.b, z.b)
+            self.assertEqual(y.v, z.v)
+            self.assertEqual((x / n).interval, (x / flint(n)).interval)
+            self.assertEqual((n / x).interval, (flint(n) / x).interval)
+            z = flint(1.5)
+            z -= n
+            self.assertEqual(z.interval, (x - flint(n)).interval)
+            self.assertEqual(x < n, x < flint(n))
+            self.assertEqual(x == n, x == flint(n))
+        self.assertEqual(flint(3) - 3, 0)
+        with self.assertRaises(TypeError):
+            x + "1.5"
+        # Conversion errors are passed on like in the constructor
+        with self.assertRaises(OverflowError):
+            flint(10**400)
+        with self.assertRaises(OverflowError):
+            x + 10**400
+        with self.assertRaises(OverflowError):
+            10**400 * x
+        with self.assertRaises(OverflowError):
+            x < 10**400
+        class BadFloat:
+            def __float__(self):
+                raise ZeroDivisionError
+        with self.assertRaises(ZeroDivisionError):
+            x + BadFloat()
+        # Arrays are handed to numpy
+        y = x + np.array([1.0, 2.0])
+        self.assertIsInstance(y, np.ndarray)
+        self.assertEqual(y.dtype, flint)
+
     def test_iadd(self):
         """Validate inplace addition"""
         x = flint(1)
@@ -354,6 +474,50 @@ class TestArithmetic(unittest.TestCase):
         self.assertTrue(x.eps > 0)
         self.assertEqual(x, 2)
 
+    def test_number_operands(self):
+        """Validate mixed operations with python and numpy numbers"""
+        x = flint(1.5)
+        for n in [2, 2.0, True, np.float64(2), np.int32(2)]:
+            self.assertEqual((x * n).interval, (x * flint(n)).interval)
+            self.assertEqual((n * x).interval, (flint(n) * x).interval)
+            self.assertEqual((n - x).interval, (flint(n) - x).interval)
+            self.assertEqual((n / x).interval, (flint(n) / x).interval)
+            self.assertEqual((n ** x).interval, (flint(n) ** x).interval)
+        self.assertFalse(x == 'a')
+        self.assertTrue(x != None)
+        with self.assertRaises(TypeError):
+            x + 'a'
+        with self.assertRaises(TypeError):
+            None * x
+        with self.assertRaises(TypeError):
+            x < 'a'
+
+    def test_rounding_mode(self):
+        """Validate the reported rounding mode"""
+        self.assertIn(flint_module.rounding_mode, ('nextafter', 'directed'))
+
+    def test_bounds_enclose(self):
+        """Validate the boundaries enclose the exact result of exact inputs"""
+        one_third = Fraction(1, 3)
+        x = flint(1)/flint(3)
+        self.assertTrue(Fraction(x.a) <= one_third <= Fraction(x.b))
+        x = flint(-1)/flint(3)
+        self.assertTrue(Fraction(x.a) <= -one_third <= Fraction(x.b))
+        x = flint(1)
+        x /= flint(3)
+        self.assertTrue(Fraction(x.a) <= one_third <= Fraction(x.b))
+        x = flint(0)
+        x.interval = 0.1, 0.1, 0.1
+        y = x*x
+        self.assertTrue(Fraction(y.a) <= Fraction(0.1)**2 <= Fraction(y.b))
+        y = x + x + x
+        self.assertTrue(Fraction(y.a) <= 3*Fraction(0.1) <= Fraction(y.b))
+        y = x - 0.3
+        self.assertTrue(Fraction(y.a) <= Fraction(0.1) - Fraction(0.3) <= Fraction(y.b))
+        a = np.full((1000,), x, dtype=flint)
+        b = a*a
+        self.assertTrue(all(Fraction(y.a) <= Fraction(0.1)**2 <= Fraction(y.b) for y in b))
+
 
 class TestGeneralMath(unittest.TestCase):
     """Test the general math functions"""
@@ -945,6 +1109,134 @@ class TestInvHyperTrigMath(unittest.TestCase):
         self.assertTrue(np.isnan(y.v))
 
 
+class TestRounding(unittest.TestCase):
+    """Test the rounding and remainder functions"""
+
+    v = [-2.5, -1.25, -0.5, 0.0, 0.75, 1.5, 2.5, 3.0]*4
+    y = [2, -2, 0.75, 3]*8
+
+    def check_rounding(self, f):
+        """Check a rounding function for scalars, flint arrays, and flint32 arrays"""
+        # 32 elements are long enough for the vector kernels
+        x = np.array(self.v, dtype=flint)
+        r = f(x)
+        self.assertEqual(r.dtype, flint)
+        for i, v in enumerate(self.v):
+            self.assertTrue(r[i].a <= f(v) <= r[i].b)
+            self.assertEqual(r[i].v, f(v))
+            self.assertEqual(r[i].a, f(r[i].a))
+            self.assertEqual(r[i].b, f(r[i].b))
+        r = f(np.array(self.v, dtype=flint32))
+        self.assertEqual(r.dtype, flint32)
+        self.assertTrue(all(r[i] == f(v) for i, v in enumerate(self.v)))
+        y = f(flint(1.9, 2.1, 2.0))
+        self.assertIsInstance(y, flint)
+        self.assertEqual(y.v, f(2.0))
+
+    def check_remainder(self, f):
+        """Check that a remainder function contains the float results"""
+        x = np.array(self.v, dtype=flint)
+        y = np.array(self.y, dtype=flint)
+        for r in [f(x, y), f(x.astype(flint32), y.astype(flint32))]:
+            for i, v in enumerate(self.v):
+                e = f(v, self.y[i])
+                self.assertTrue(r[i].a <= e <= r[i].b)
+                self.assertTrue(r[i] == e)
+        r = f(x, y)
+        self.assertEqual([r[i].v for i in range(len(self.v))],
+                         [f(v, self.y[i]) for i, v in enumerate(self.v)])
+
+    def test_floor(self):
+        """Validate floor"""
+        self.check_rounding(np.floor)
+        y = np.floor(flint(1.9, 2.1, 2.0))
+        self.assertEqual(y.interval, (1, 2))
+        self.assertEqual(flint(-1.5).floor(), -2)
+
+    def test_ceil(self):
+        """Validate ceil"""
+        self.check_rounding(np.ceil)
+        self.assertEqual(np.ceil(flint(0.5)), 1)
+        self.assertEqual(flint(-1.5).ceil(), -1)
+
+    def test_trunc(self):
+        """Validate trunc"""
+        self.check_rounding(np.trunc)
+        self.assertEqual(np.trunc(flint(-1.25)), -1)
+        self.assertEqual(flint(1.75).trunc(), 1)
+
+    def test_rint(self):
+        """Validate rint"""
+        self.check_rounding(np.rint)
+        self.assertEqual(np.rint(flint(2.5)).v, 2)
+        self.assertEqual(flint(-1.75).rint(), -2)
+
+    def test_fmod(self):
+        """Validate fmod"""
+        self.check_remainder(np.fmod)
+        self.assertEqual(flint(-7.0).fmod(2), -1)
+        y = np.fmod(flint(-0.5, 0.5, 0.0), flint(0.3))
+        self.assertEqual(y.a, -y.b)
+        self.assertTrue(0.3 <= y.b < 0.31)
+        self.assertTrue(np.isnan(np.fmod(flint(1), flint(0, 0, 0))))
+        y = np.fmod(flint(1), flint(0))
+        self.assertEqual(y.a, 0)
+        self.assertTrue(y.b > 0)
+        self.assertTrue(np.isnan(y.v))
+        y = np.fmod(flint(0.5, 1, 0.75), flint(2, np.inf, 3))
+        self.assertEqual(y.interval, (0.5, 1))
+        self.assertEqual(y.v, 0.75)
+
+    def test_remainder(self):
+        """Validate remainder and the % operator"""
+        self.check_remainder(np.remainder)
+        self.assertEqual(flint(7.0) % 2, 1)
+        self.assertEqual(flint(-7.0) % 2, 1)
+        self.assertEqual(7 % flint(-2.0), -1)
+        y = flint(1.9, 2.1, 2.0) % 2
+        self.assertEqual(y.a, 0)
+        self.assertTrue(2 <= y.b < 2.1)
+        self.assertEqual(y.v, 0)
+        self.assertTrue(np.isnan((flint(1) % flint(0)).v))
+        y = np.remainder(flint(0.5, 1, 0.75), flint(2, np.inf, 3))
+        self.assertEqual(y.interval, (0.5, 1))
+        self.assertEqual(y.v, 0.75)
+
+    def test_floor_divide(self):
+        """Validate floor_divide and the // operator"""
+        self.check_remainder(np.floor_divide)
+        self.assertEqual(flint(7.0) // 2, 3)
+        self.assertEqual(flint(-7.0) // 2, -4)
+        y = flint(1) // flint(-1, 1, 0.5)
+        self.assertEqual(y.interval, (-np.inf, np.inf))
+        # The tracked value follows numpy for divisors that are not dyadic
+        x, y = flint(1), flint(0.1)
+        self.assertEqual((x // y).v, 1 // 0.1)
+        self.assertEqual((x // y).v, np.floor_divide(1.0, 0.1))
+        self.assertTrue((x // y).a <= 9 and (x // y).b >= 10)
+        self.assertEqual(((x // y)*y + x % y).v, (1 // 0.1)*0.1 + 1 % 0.1)
+        self.assertEqual((flint(-1) // flint(0.1)).v, -1 // 0.1)
+        # NaNs and an exactly zero divisor give NaN
+        self.assertTrue(np.isnan(flint(np.nan) // flint(-1, 1, 0.5)))
+        self.assertTrue(np.isnan(flint(1) // flint(0, 0, 0)))
+
+    def test_modf(self):
+        """Validate modf"""
+        x = np.array(self.v, dtype=flint)
+        for dtype in [flint, flint32]:
+            fr, ip = np.modf(x.astype(dtype))
+            self.assertEqual(fr.dtype, dtype)
+            self.assertEqual(ip.dtype, dtype)
+            for i, v in enumerate(self.v):
+                self.assertTrue(fr[i] == np.modf(v)[0])
+                self.assertTrue(ip[i] == np.modf(v)[1])
+        fr, ip = np.modf(flint(0.5, 2.5, 1.5))
+        self.assertEqual(fr.interval, (0, 1))
+        self.assertEqual(ip.interval, (0, 2))
+        self.assertEqual(fr.v, 0.5)
+        self.assertEqual(ip.v, 1)
+
+
 class TestNumpyArray():
 
     def test_array(self):
@@ -1001,3 +1293,553 @@ class TestNumpyArray():
         assert np.alltrue( a[:,0] == zero_row )
         assert np.alltrue( a[:,1] == b )
         assert np.alltrue( a[:,2] == zero_row )
+
+    def test_vector_kernels(self):
+        assert flint_module.simd in ('baseline', 'avx2', 'avx512f')
+        vals = np.linspace(-3, 3, 101)
+        a = np.array(vals, dtype=flint)
+        b = np.array(vals[::-1]/7, dtype=flint)
+        x = flint(0)
+        x.interval = -1, 2
+        a[10] = x
+        x.interval = -2, -1
+        b[20] = x
+        def same(x, y):
+            return all(p == q or (np.isnan(p) and np.isnan(q))
+                       for p, q in zip(x.interval, y.interval))
+        for op in [np.add, np.subtract, np.multiply, np.divide]:
+            c = op(a, b)
+            assert all(same(c[i], op(a[i], b[i])) for i in range(len(a)))
+            c = op(a[::2], b[1::2])
+            assert all(same(c[i], op(a[2*i], b[2*i+1])) for i in range(len(c)))
+        for op in [np.negative, np.absolute, np.sqrt]:
+            c = op(a)
+            assert all(same(c[i], op(a[i])) for i in range(len(a)))
+        for op in [np.equal, np.not_equal, np.less, np.less_equal,
+                   np.greater, np.greater_equal]:
+            c = op(a, b)
+            assert all(c[i] == op(a[i], b[i]) for i in range(len(a)))
+
+    def test_releases_gil(self):
+        # Only getitem and setitem need the python api, NPY_NEEDS_PYAPI is 0x10
+        assert np.dtype(flint).flags & 0x10 == 0
+        a = np.arange(10000, dtype=flint)
+        chunks = np.split(a, 8)
+        with ThreadPoolExecutor(4) as pool:
+            results = list(pool.map(lambda c: np.sqrt(c*c + 1), chunks))
+        expected = np.sqrt(a*a + 1)
+        assert all(x.interval == y.interval
+                   for x, y in zip(np.concatenate(results), expected))
+
+    def test_threads(self):
+        assert flint_module.get_num_threads() >= 1
+        try:
+            flint_module.set_num_threads(0)
+            assert False
+        except ValueError:
+            pass
+        # The argument errors are passed through unchanged
+        for n, err in [('4', TypeError), (2**40, OverflowError)]:
+            try:
+                flint_module.set_num_threads(n)
+                assert False
+            except err:
+                pass
+        a = np.array(np.linspace(-4, 4, 100003), dtype=flint)
+        b = np.array(np.linspace(1, 3, 100003), dtype=flint)
+        n = flint_module.get_num_threads()
+        try:
+            flint_module.set_num_threads(1)
+            expected = [a+b, a*b, a < b, np.sin(a), np.power(b, a), np.arctan2(a, b),
+                        np.add.accumulate(a)]
+            flint_module.set_num_threads(4)
+            assert flint_module.get_num_threads() == 4
+            results = [a+b, a*b, a < b, np.sin(a), np.power(b, a), np.arctan2(a, b),
+                       np.add.accumulate(a)]
+        finally:
+            flint_module.set_num_threads(n)
+        assert np.all(results[2] == expected[2])
+        for x, y in zip(results[:2] + results[3:], expected[:2] + expected[3:]):
+            assert all(p.interval == q.interval for p, q in zip(x, y))
+
+    def test_reductions(self):
+        vals = np.linspace(-1, 3, 10007)
+        a = np.array(vals, dtype=flint)
+        s = np.sum(a)
+        exact = sum(Fraction(v) for v in vals)
+        assert Fraction(s.a) <= exact <= Fraction(s.b)
+        # The pairwise sum is no wider than the sequential one
+        seq = a[0]
+        for x in a[1:]:
+            seq += x
+        assert s.eps <= seq.eps
+        assert s == vals.sum()
+        assert np.mean(a) == vals.mean()
+        b = np.array(1 + vals/1e5, dtype=flint)
+        p = np.prod(b)
+        exact = 1
+        for v in b:
+            exact *= Fraction(v.v)
+        assert Fraction(p.a) <= exact <= Fraction(p.b)
+
+    def test_minimum_maximum(self):
+        x = flint(0)
+        x.interval = -1, 2
+        y = flint(1)
+        assert np.minimum(x, y).interval == (-1, 1)
+        assert np.maximum(x, y).interval == (1, 2)
+        assert np.isnan(np.minimum(x, flint(np.nan)))
+        a = np.array(np.linspace(-4, 4, 1001), dtype=flint)
+        assert np.min(a).v == -4
+        assert np.max(a).v == 4
+        a[500] = flint(np.nan)
+        assert np.isnan(np.max(a))
+
+    def test_mixed_double(self):
+        a = np.array(np.linspace(-3, 3, 301), dtype=flint)
+        d = np.linspace(-2, 5, 301)
+        fd = np.array(d, dtype=flint)
+        for op in [np.add, np.subtract, np.multiply, np.divide]:
+            for x, y in [(op(a, d), op(a, fd)), (op(d, a), op(fd, a)),
+                         (op(a, 2.5), op(a, flint(2.5))),
+                         (op(-0.1, a), op(flint(-0.1), a))]:
+                assert x.dtype == flint
+                assert all(p.interval == q.interval for p, q in zip(x, y))
+        for op in [np.equal, np.not_equal, np.less, np.less_equal,
+                   np.greater, np.greater_equal]:
+            assert np.all(op(a, d) == op(a, fd))
+            assert np.all(op(d, a) == op(fd, a))
+            assert np.all(op(a, 0.5) == op(a, flint(0.5)))
+
+    def test_astype(self):
+        vals = np.linspace(-3, 3, 1001)
+        a = np.array(vals, dtype=flint)
+        assert np.all(a.astype(np.float64) == vals)
+        assert np.all(a.astype(np.float32) == vals.astype(np.float32))
+        assert np.all(a.astype(np.int64) == vals.astype(np.int64))
+        assert np.all(a.astype(np.bool_) == vals.astype(np.bool_))
+        c = a.astype(np.complex128)
+        assert np.all(c.real == vals) and np.all(c.imag == 0)
+        # Strided arrays go through NumPy's buffering
+        assert np.all(a[::3].astype(np.float64) == vals[::3])
+
+    def test_components(self):
+        x = flint(0)
+        x.interval = -1, 2, 0.5
+        a = np.array([[x, flint(3)], [flint(4), flint(5)]], dtype=flint)
+        lo, hi, v = flint_module.components(a)
+        assert lo.dtype == np.float64 and lo.shape == (2, 2)
+        assert lo[0, 0] == -1 and hi[0, 0] == 2 and v[0, 0] == 0.5
+        assert v[1, 1] == 5
+        # The views share memory with the flint array
+        assert np.shares_memory(lo, a)
+        lo[1, 0] = -7
+        assert a[1, 0].a == -7
+        # Strided arrays give strided views
+        lo_t, _, _ = flint_module.components(a.T[:, ::-1])
+        assert lo_t[0, 1] == -1
+        # Views of one flint array wrap back without a copy
+        b = flint_module.from_components(lo, hi, v)
+        assert b.dtype == flint and np.shares_memory(b, a)
+        c = flint_module.from_components(lo, hi, v, copy=True)
+        assert not np.shares_memory(c, a)
+        assert all(p.interval == q.interval for p, q in zip(c.ravel(), a.ravel()))
+        # Separate arrays are copied once
+        d = flint_module.from_components(np.zeros(3), np.ones(3))
+        assert d[1].interval == (0, 1) and d[1].v == 0.5
+        try:
+            flint_module.from_components(np.zeros(3), np.ones(3), np.ones(3), copy=False)
+            assert False
+        except ValueError:
+            pass
+
+    def test_from_bounds(self):
+        x = flint_module.from_bounds([1.0, 2.0], [1.5, 3.0])
+        assert x.dtype == flint and x.shape == (2,)
+        assert x[0].interval == (1.0, 1.5) and x[0].v == 1.25
+        assert x[1].interval == (2, 3) and x[1].v == 2.5
+        # Inputs are broadcast and converted to float64
+        y = flint_module.from_bounds(np.arange(6).reshape(2, 3), 10, v=np.float32(5))
+        assert y.shape == (2, 3)
+        assert y[1, 2].interval == (5, 10) and y[1, 2].v == 5
+        z = flint_module.from_bounds(np.zeros((0, 3)), np.ones(3))
+        assert z.shape == (0, 3)
+        try:
+            flint_module.from_bounds(np.zeros(2), np.ones(3))
+            assert False
+        except ValueError:
+            pass
+
+    def test_assign_numbers(self):
+        vals = [0.0, -0.0, 1.5, -2.25, 5e-324, np.inf]
+        a = np.array(vals, dtype=flint)
+        b = np.array(vals).astype(flint)
+        for x, y, d in zip(a, b, vals):
+            assert x.interval == y.interval
+            assert x.a == np.nextafter(d, -np.inf) and x.b == np.nextafter(d, np.inf)
+        c = np.zeros(6, dtype=flint)
+        c[::2] = np.arange(3, dtype=np.int64)
+        c[1::2] = [1, 2.5, np.float32(3)]
+        assert c[2].v == 1 and c[3].v == 2.5 and c[5].v == 3
+        try:
+            c[0] = 'a'
+            assert False
+        except TypeError:
+            pass
+
+    def test_copies(self):
+        a = flint_module.from_bounds(np.arange(12.0), np.arange(12.0) + 0.5)
+        idx = [11, 0, 5, 5]
+        for b in [np.take(a, idx), a[idx], a.reshape(3, 4).T.copy().T.ravel()[idx]]:
+            assert all(x.interval == a[i].interval for x, i in zip(b, idx))
+        c = a[::3].copy()
+        assert c.flags.c_contiguous and c[2].interval == a[6].interval
+        d = a.byteswap()
+        assert d.byteswap()[4].interval == a[4].interval
+        assert d[4].interval != a[4].interval
+
+    def test_sort(self):
+        a = flint_module.from_bounds([3, 1, 2, 1, np.nan, 0], [4, 2, 5, 3, 1, 0])
+        for kind in ['quicksort', 'heapsort', 'stable']:
+            s = np.sort(a, kind=kind)
+            assert [x.interval for x in s[:5]] == [(0, 0), (1, 2), (1, 3), (2, 5), (3, 4)]
+            assert np.isnan(s[5].a)
+            i = np.argsort(a, kind=kind)
+            assert list(i) == [5, 1, 3, 2, 0, 4]
+        b = np.sort(np.array(np.linspace(-1, 1, 10001), dtype=flint))[::-1].copy()
+        b.sort()
+        assert all(b[j].a < b[j+1].a for j in range(len(b)-1))
+        assert np.searchsorted(b, b[1234]) == 1234
+        assert np.searchsorted(np.sort(a), a[2], side='right') == 4
+
+    def test_extrema(self):
+        a = flint_module.from_bounds([3, 0, 2, -1], [4, 5, 2.5, 6])
+        assert a.argmin() == 3 and a.argmax() == 3
+        assert a[:3].argmin() == 1 and a[:3].argmax() == 1
+        b = flint_module.from_bounds([1, np.nan, 0, 2], [2, 1, 0, 3])
+        assert b.argmax() == 1 and b.argmin() == 1
+        m = np.minimum(a, 1.0)
+        one = flint(1.0)
+        assert m[0].interval == one.interval and m[1].interval == (0, one.b)
+        assert all(np.isnan(x.a) for x in np.maximum(a, b)[1:2])
+        f = np.fmin(a, b)
+        assert f[1].interval == a[1].interval and f[0].interval == (1, 2)
+        f = np.fmax(a, b)
+        assert f[1].interval == a[1].interval and f[3].interval == (2, 6)
+        c = a.reshape(2, 2)
+        assert c.min(axis=0)[0].interval == (2, 2.5)
+        assert c.max(axis=1)[1].interval == (2, 6)
+        assert np.fmin.reduce(b).interval == (0, 0)
+
+    def test_accumulate(self):
+        # Longer than a block of the vector kernels, each output is the next input
+        a = np.array(np.linspace(0.5, 1.5, 1000), dtype=flint)
+        a[::7] = -a[::7]
+        for f in [np.add, np.multiply, np.maximum, np.minimum, np.fmax, np.fmin]:
+            r = f.accumulate(a)
+            s = a[0]
+            for i in range(len(a)):
+                s = f(s, a[i]) if i > 0 else s
+                assert (r[i].interval, r[i].v) == (s.interval, s.v)
+        assert np.cumsum(a)[-1].interval == np.add.accumulate(a)[-1].interval
+
+    def test_matmul(self):
+        a = np.array(np.linspace(-1, 2, 30*20).reshape(30, 20), dtype=flint)
+        b = np.array(np.cos(np.arange(20*17.0)).reshape(20, 17), dtype=flint)
+        for x, y in [(a, b), (a[:, ::2], b[::2, 1:3]), (a[:4].T, a[:4]), (a, b[:, 5])]:
+            c = x @ y
+            assert c.shape == np.matmul(x.astype(float), y.astype(float)).shape
+            c = c.reshape(x.shape[0], -1)
+            yy = y.reshape(y.shape[0], -1)
+            for i, j in [(0, 0), (x.shape[0]-1, yy.shape[1]-1), (3, yy.shape[1]//2)]:
+                # The sums are in order, with fused multiply-adds if the cpu has them
+                s = t = x[i, 0]*yy[0, j]
+                for k in range(1, x.shape[1]):
+                    s = x[i, k].fma(yy[k, j], s)
+                    t = t + x[i, k]*yy[k, j]
+                assert (c[i, j].interval, c[i, j].v) in [(s.interval, s.v), (t.interval, t.v)]
+                assert c[i, j] == s
+                assert c[i, j].a <= s.v <= c[i, j].b
+        d = np.dot(a, b)
+        assert all(d[i, j] == (a @ b)[i, j] for i, j in [(0, 0), (29, 16)])
+        e = np.ones((2, 3, 4), dtype=flint) @ np.ones((4, 5), dtype=flint)
+        assert e.shape == (2, 3, 5) and e[1, 2, 4] == 4
+        z = np.ones((3, 0), dtype=flint) @ np.ones((0, 2), dtype=flint)
+        assert z.shape == (3, 2) and z[0, 0].interval == (0, 0)
+
+    def test_fma(self):
+        x = np.array(np.linspace(-2, 3, 50), dtype=flint)
+        y = np.array(np.cos(np.arange(50.0)), dtype=flint)
+        z = np.array(np.sin(np.arange(50.0)), dtype=flint)
+        r = flint_module.fma(x, y, z)
+        s = x*y + z
+        for i in range(50):
+            assert s[i].a <= r[i].a and r[i].b <= s[i].b
+            assert r[i].a <= x[i].v*y[i].v + z[i].v <= r[i].b
+            assert r[i].interval == x[i].fma(y[i], z[i]).interval
+        c = [3.0, 2.0, -1.0, 0.5]
+        p = np.zeros(50, dtype=flint)
+        for ci in c:
+            p = flint_module.fma(p, x, ci)
+        assert all(p[i] == ((3*x[i] + 2)*x[i] - 1)*x[i] + 0.5 for i in range(50))
+        assert flint(2).fma(3, 1) == 7
+        try:
+            flint(2).fma(3)
+            assert False
+        except TypeError:
+            pass
+
+    def test_trig(self):
+        v = np.linspace(-40, 40, 1001)
+        x = np.array(v, dtype=flint)
+        w = flint_module.from_bounds(v-1e-9, v+2e-9)
+        for f in [np.sin, np.cos]:
+            for y, lo, hi in [(f(x), v, v), (f(w), v-1e-9, v+2e-9)]:
+                for i in range(0, 1001, 7):
+                    assert y[i].v == f(v[i]) or lo[i] != hi[i]
+                    for t in [lo[i], v[i], hi[i]]:
+                        assert y[i].a <= f(t) <= y[i].b
+                    assert y[i].b - y[i].a < 1e-8
+        assert np.sin(flint_module.from_bounds(0, 7)).interval == (-1, 1)
+        assert np.sin(flint_module.from_bounds(1.5, 1.6)).b == 1
+        assert np.cos(flint_module.from_bounds(3.1, 3.2)).a == -1
+        assert np.cos(flint_module.from_bounds(1e30, 1e30)).b <= 1
+        assert np.isnan(np.sin(flint_module.from_bounds(np.nan, 1)).a)
+
+    def test_mean_value(self):
+        v = np.linspace(-3, 3, 301)
+        for d in [0, 1e-12, 0.5]:
+            x = flint_module.from_bounds(v-d, v+d)
+            for f in [np.exp, np.exp2, np.expm1, np.arctan, np.sinh, np.tanh, np.arcsinh]:
+                y = f(x)
+                for i in range(0, 301, 5):
+                    assert y[i].v == f(x[i].v)
+                    assert y[i].a <= f(x[i].a) and f(x[i].b) <= y[i].b
+                    assert y[i].a <= y[i].v <= y[i].b
+        x = flint(1.0)
+        x.interval = 2, 3, 1
+        y = np.exp(x)
+        assert y.v == np.exp(1.0) and y.a <= np.exp(2) and np.exp(3) <= y.b
+        assert np.isnan(np.exp(flint_module.from_bounds(np.nan, 1)).a)
+        assert np.exp(flint(1000)).b == np.inf
+
+    def test_integer_power(self):
+        x = flint_module.from_bounds([-1, 2, -3, -2], [2, 3, -2, 0.5])
+        y = x**2
+        assert y[0].interval == (0, np.square(x[0]).b) and y[0].b >= 4
+        assert y[1].a <= 4 and 9 <= y[1].b and y[1].v == x[1].v**2
+        assert y[2].a <= 4 and 9 <= y[2].b
+        y = x**3
+        assert y[0].a <= -1 and 8 <= y[0].b and y[0].a > -1.01
+        assert y[2].a <= -27 and -8 <= y[2].b < 0
+        y = x**np.arange(4)
+        assert y[0] == 1 and y[0].eps == 0 and y[1] == x[1] and y[3].a <= -8
+        y = x**-2
+        assert y[1].a <= 1/9 and 1/4 <= y[1].b and y[0].b == np.inf
+        z = flint(2)
+        assert (z**10).interval[0] <= 1024 <= (z**10).interval[1]
+        assert z**0 == 1 and (z**-1).v == 0.5
+        z **= 3
+        assert z == 8
+        assert np.isnan((flint_module.from_bounds(np.nan, 1)**2).a)
+        s = np.square(x)
+        assert all(s[i] == x[i]*x[i] for i in range(4))
+        assert s[3].a == 0 and s[3].v == x[3].v*x[3].v
+
+    def test_flint32(self):
+        a = np.array([1.5, 0.1, 3], dtype=flint32)
+        assert a.dtype.itemsize == 12
+        assert isinstance(a[0], flint32) and isinstance(a[0], flint)
+        assert a[1].a < 0.1 < a[1].b
+        assert a[1].a == np.nextafter(np.float32(0.1), np.float32(-1))
+        x = a.astype(flint)
+        assert x.dtype == flint
+        assert all(x[i].interval == a[i].interval and x[i].v == a[i].v for i in range(3))
+        y = flint_module.from_bounds([0.1, 1/3, -1e300], [0.2, 0.5, 1e300])
+        z = y.astype(flint32)
+        assert z.dtype == flint32
+        for i in range(3):
+            assert z[i].a <= y[i].a and y[i].b <= z[i].b
+        assert z[0].b - z[0].a < 0.1 + 3e-8
+        assert z[2].a == -np.inf and z[2].b == np.inf
+        for f in [np.sin, np.exp, np.sqrt, np.arctan, np.negative]:
+            r = f(a)
+            assert r.dtype == flint32
+            s = f(x)
+            assert all(r[i].a <= s[i].a and s[i].b <= r[i].b for i in range(3))
+        r = a + a*a
+        assert r.dtype == flint32 and r[2] == 12
+        assert (a + x).dtype == flint
+        assert a.sum().interval[0] <= 4.6 <= a.sum().interval[1]
+        assert np.sort(a)[0] == a[1] and np.argmax(a) == 2
+        assert list(a == x) == [True, True, True]
+        b = flint32(0.1)
+        assert b.interval == a[1].interval and isinstance(b + b, flint)
+
+    def test_serialize(self):
+        x = flint_module.from_bounds([0.1, -np.inf, 1], [0.2, 3, np.inf], [0.15, 0, np.inf])
+        x = x.reshape(3, 1)
+        same = lambda a, b: (a.dtype == b.dtype and a.shape == b.shape and
+            np.array_equal(flint_module.as_records(a), flint_module.as_records(b)))
+        for a in [x, x.astype(flint32)]:
+            for protocol in [2, 5]:
+                assert same(pickle.loads(pickle.dumps(a, protocol=protocol)), a)
+            buffers = []
+            f = io.BytesIO()
+            flint_module.Pickler(f, protocol=5, buffer_callback=buffers.append).dump(a)
+            assert len(buffers) == 1
+            assert same(pickle.loads(f.getvalue(), buffers=buffers), a)
+            assert same(flint_module.from_bytes(flint_module.to_bytes(a)), a)
+            f = io.BytesIO()
+            np.save(f, flint_module.as_records(a))
+            f.seek(0)
+            assert same(flint_module.from_records(np.load(f)), a)
+        rec = flint_module.as_records(x).astype([('a', '>f8'), ('b', '>f8'), ('v', '>f8')])
+        assert same(flint_module.from_records(rec), x)
+        data = flint_module.to_bytes(x, 'offsets')
+        assert len(data) < len(flint_module.to_bytes(x))
+        y = flint_module.from_bytes(data)
+        assert y.dtype == flint and y.shape == x.shape
+        for i in range(3):
+            assert y[i,0].a <= x[i,0].a and x[i,0].b <= y[i,0].b and y[i,0].v == x[i,0].v
+        assert y[0,0].b - y[0,0].a < 0.1 + 1e-8
+
+    def test_memmap(self):
+        with tempfile.TemporaryDirectory() as d:
+            name = os.path.join(d, 'x.npy')
+            x = flint_module.open_memmap(name, 'w+', shape=(1000, 3))
+            assert isinstance(x, np.memmap) and x.dtype == flint
+            x[...] = np.arange(3000).reshape(1000, 3)
+            x.flush()
+            del x
+            x = flint_module.open_memmap(name, 'r')
+            assert x.shape == (1000, 3) and x[10, 1] == 31
+            assert flint_module.from_records(np.load(name))[10, 1] == 31
+            s = flint_module.reduce_blocks(np.add, x, block_size=64)
+            assert s.shape == (3,) and s[0] == 1498500
+            assert all(s[i] == np.add.reduce(x)[i] for i in range(3))
+            out = flint_module.open_memmap(os.path.join(d, 'y.npy'), 'w+', shape=(1000, 3))
+            y = flint_module.apply_blocks(lambda x, y: x*y + 1, x, x, out=out, block_size=99)
+            assert y is out and y[10, 1] == 962 and y[999, 2] == 2999**2 + 1
+            z = flint_module.apply_blocks(np.sqrt, x)
+            assert type(z) is np.ndarray and z.dtype == flint and z[1, 1] == 2
+            x32 = flint_module.open_memmap(os.path.join(d, 'z.npy'), 'w+', flint32, (10,))
+            assert x32.dtype == flint32 and x32.nbytes == 120
+            del x, y, out, x32
+
+    def test_evaluate(self):
+        x = np.array([3, 0.5, -2], dtype=flint)
+        y = np.array([[4], [1.5]])
+        k = flint(0.1)
+        r = flint_module.evaluate('sqrt(x*x + y*y)*k')
+        s = np.sqrt(x*x + y.astype(flint)*y.astype(flint))*k
+        assert r.dtype == flint and r.shape == (2, 3)
+        assert all(r[i,j].interval == s[i,j].interval for i in range(2) for j in range(3))
+        r = flint_module.evaluate('x**2 - 2*arctan2(y, x) + fma(x, x, 1)', {'x': x, 'y': 1.0})
+        for i, v in enumerate([3, 0.5, -2]):
+            assert r[i] == 2*v*v + 1 - 2*np.arctan2(1.0, v)
+        out = np.zeros(3, dtype=flint)
+        assert flint_module.evaluate('-abs(x)', out=out) is out and out[2] == -2
+        assert flint_module.evaluate('x**-1')[1] == 2
+        r = flint_module.evaluate('floor(x) + x % 2')
+        assert r[0] == 4 and r[1] == 0.5 and r[2] == -2
+        for ex in ['x < 1', 'sqrt(x, x)', 'foo(x)', 'z + 1']:
+            try:
+                flint_module.evaluate(ex)
+                assert False
+            except (ValueError, TypeError, NameError):
+                pass
+
+    def test_stats(self):
+        flint_module.reset_stats()
+        flint_module.set_stats(True)
+        try:
+            x = np.arange(10, dtype=np.float64).astype(flint)
+            y = x*x
+            flint_module.set_stats(False)
+            y + y
+        finally:
+            flint_module.set_stats(False)
+        s = flint_module.stats()
+        assert s['loops']['multiply']['elements'] == 10 and 'add' not in s['loops']
+        assert s['loops']['multiply']['calls'] >= 1 and s['loops']['multiply']['seconds'] >= 0
+        assert s['casts']['double->flint']['elements'] == 10
+        assert sum(s['eps'].values()) == 10
+        for edge, count in s['eps'].items():
+            assert sum(edge <= y[i].eps < 2*edge or edge == y[i].eps == 0 for i in range(10)) == count
+        # Both of the modf outputs go in the histogram
+        flint_module.reset_stats()
+        flint_module.set_stats(True)
+        try:
+            np.modf(x)
+        finally:
+            flint_module.set_stats(False)
+        s = flint_module.stats()
+        assert s['loops']['modf']['elements'] == 10 and sum(s['eps'].values()) == 20
+        flint_module.reset_stats()
+        s = flint_module.stats()
+        assert s['loops'] == {} and s['casts'] == {} and s['eps'] == {}
+
+
+class TestCHeaders(unittest.TestCase):
+    """Build and run the checks of the pure C headers"""
+
+    def test_soa(self):
+        """Validate the flint_soa batch functions against the single flint functions"""
+        cc = shutil.which(os.environ.get('CC', 'cc'))
+        if sys.platform == 'win32' or cc is None:
+            self.skipTest('needs a unix c compiler')
+        src = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'test_soa.c')
+        with tempfile.TemporaryDirectory() as d:
+            exe = os.path.join(d, 'test_soa')
+            for flags in [[], ['-DFLINT_DIRECTED_ROUNDING', '-frounding-math']]:
+                subprocess.run([cc, '-O2', '-fno-math-errno', '-ffp-contract=off', *flags,
+                                '-I', flint_module.get_include(), src, '-o', exe, '-lm'],
+                               check=True)
+                r = subprocess.run([exe], capture_output=True, text=True)
+                self.assertEqual(r.returncode, 0, r.stdout)
+
+
+class TestCApi(unittest.TestCase):
+    """Test the batch functions in the c api capsule against the ufuncs"""
+
+    # The batch functions in the order of their slots in numpy_flint.h, after the
+    # three slots for the type, the dtype number, and pyflint_from_flint
+    funcs = ['add', 'subtract', 'multiply', 'divide', 'power', 'hypot', 'atan2',
+             'negative', 'absolute', 'sqrt', 'cbrt', 'exp', 'exp2', 'expm1', 'log',
+             'log10', 'log2', 'log1p', 'sin', 'cos', 'tan', 'asin', 'acos', 'atan',
+             'sinh', 'cosh', 'tanh', 'asinh', 'acosh', 'atanh']
+
+    def get_func(self, name, strided, argtypes):
+        """Get a batch function from the capsule"""
+        get_pointer = ctypes.pythonapi.PyCapsule_GetPointer
+        get_pointer.restype = ctypes.c_void_p
+        get_pointer.argtypes = [ctypes.py_object, ctypes.c_char_p]
+        api = get_pointer(flint_module.numpy_flint.c_api, b'flint.numpy_flint.c_api')
+        slot = 3 + 2*self.funcs.index(name) + strided
+        ptr = ctypes.c_void_p.from_address(api + slot*ctypes.sizeof(ctypes.c_void_p))
+        # Keep the GIL, the functions run on the module's own threads
+        return ctypes.PYFUNCTYPE(None, *argtypes)(ptr.value)
+
+    def assertSame(self, x, y):
+        """Assert that two flint arrays hold the same intervals and tracked values"""
+        self.assertEqual(x.shape, y.shape)
+        for p, q in zip(x, y):
+            self.assertEqual((p.interval, p.v), (q.interval, q.v))
+
+    def test_binary_n(self):
+        """Validate a contiguous binary batch function"""
+        x = np.array(np.linspace(-4, 4, 101), dtype=flint)
+        y = np.array(np.linspace(1, 3, 101), dtype=flint)
+        z = np.zeros(101, dtype=flint)
+        f = self.get_func('add', 0, [ctypes.c_void_p]*3 + [ctypes.c_size_t])
+        f(x.ctypes.data, y.ctypes.data, z.ctypes.data, len(z))
+        self.assertSame(z, np.add(x, y))
+
+    def test_unary_strided(self):
+        """Validate a strided unary batch function"""
+        x = np.array(np.linspace(0, 4, 101), dtype=flint)
+        z = np.zeros(51, dtype=flint)
+        f = self.get_func('sqrt', 1, [ctypes.c_void_p, ctypes.c_ssize_t]*2 + [ctypes.c_size_t])
+        f(x.ctypes.data, 2*x.strides[0], z.ctypes.data, z.strides[0], len(z))
+        self.assertSame(z, np.sqrt(x[::2]))
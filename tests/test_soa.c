@@ -0,0 +1,141 @@
+// Check the flint_soa.h batch functions against the flint.h functions for single flints
+// Copyright (c) 2023, Jef Wagner <jefwagner@gmail.com>
+//
+// This file is part of numpy-flint.
+//
+// Numpy-flint is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// Numpy-flint is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// numpy-flint. If not, see <https://www.gnu.org/licenses/>.
+//
+// Build and run from the top of the repository, once as is and once with
+// -DFLINT_DIRECTED_ROUNDING -frounding-math,
+//
+//     cc -O2 -fno-math-errno -ffp-contract=off -Isrc/flint tests/test_soa.c -o test_soa -lm
+//
+// It prints every mismatch and exits with 1 if there were any. The test_soa case in
+// test_flint.py does both builds.
+#include <stdio.h>
+#include <string.h>
+#include "flint_soa.h"
+
+#define N 1000
+
+// Bit for bit the same, except that any two NaNs match
+static int same(double x, double y) {
+    return (isnan(x) && isnan(y)) || memcmp(&x, &y, sizeof(double)) == 0;
+}
+
+static int same_flint(flint f, flint g) {
+    return same(f.a, g.a) && same(f.b, g.b) && same(f.v, g.v);
+}
+
+// A small linear congruential generator, so every platform checks the same values
+static unsigned long long seed = 12345;
+static double uniform(void) {
+    seed = seed*6364136223846793005ULL + 1442695040888963407ULL;
+    return (double) (seed >> 11)*0x1p-53;
+}
+
+// Mostly ordinary intervals of different widths, with some zeros, infinities, and NaNs
+static flint random_flint(int i) {
+    double specials[] = {0.0, -0.0, 1.0, INFINITY, -INFINITY, NAN};
+    double x = (uniform() - 0.5)*pow(2.0, (int) (uniform()*40) - 20);
+    double w = uniform()*pow(2.0, (int) (uniform()*60) - 50)*fabs(x);
+    flint f = {x - w, x + w, x};
+    if (i % 17 == 0) {
+        f = double_to_flint(specials[(i/17) % 6]);
+    }
+    if (i % 23 == 0) {
+        f.a = -INFINITY;
+    }
+    return f;
+}
+
+static int failures = 0;
+
+static void check(const char* name, size_t i, flint f, flint g) {
+    if (!same_flint(f, g)) {
+        failures++;
+        printf("%s [%zu]: soa (%.17g, %.17g, %.17g) != flint (%.17g, %.17g, %.17g)\n",
+               name, i, f.a, f.b, f.v, g.a, g.b, g.v);
+    }
+}
+
+#define CHECK_UNARY(name) \
+    flint_soa_##name(&x, &z); \
+    for (i=0; i<N; i++) { \
+        check(#name, i, flint_soa_get(&z, i), flint_##name(flint_soa_get(&x, i))); \
+    }
+
+#define CHECK_BINARY(name) \
+    flint_soa_##name(&x, &y, &z); \
+    for (i=0; i<N; i++) { \
+        check(#name, i, flint_soa_get(&z, i), \
+              flint_##name(flint_soa_get(&x, i), flint_soa_get(&y, i))); \
+    }
+
+#define CHECK_COMPARE(name) \
+    flint_soa_##name(&x, &y, c); \
+    for (i=0; i<N; i++) { \
+        if (c[i] != flint_##name(flint_soa_get(&x, i), flint_soa_get(&y, i))) { \
+            failures++; \
+            printf(#name " [%zu]\n", i); \
+        } \
+    }
+
+int main(void) {
+    flint_soa x, y, z;
+    flint f[N];
+    unsigned char c[N];
+    size_t i;
+    if (flint_soa_init(&x, N) || flint_soa_init(&y, N) || flint_soa_init(&z, N)) {
+        printf("could not allocate the containers\n");
+        return 1;
+    }
+    for (i=0; i<N; i++) {
+        f[i] = random_flint((int) i);
+        flint_soa_set(&y, i, random_flint((int) (i + N)));
+    }
+    // Round trip through the interleaved flints
+    flint_soa_from_flint(&x, f, sizeof(flint));
+    for (i=0; i<N; i++) {
+        check("from_flint", i, flint_soa_get(&x, i), f[i]);
+    }
+    flint_soa_to_flint(&y, f, sizeof(flint));
+    for (i=0; i<N; i++) {
+        check("to_flint", i, f[i], flint_soa_get(&y, i));
+    }
+    CHECK_UNARY(negative)
+    CHECK_BINARY(add)
+    CHECK_BINARY(subtract)
+    CHECK_BINARY(multiply)
+    CHECK_BINARY(divide)
+    CHECK_COMPARE(eq)
+    CHECK_COMPARE(ne)
+    CHECK_COMPARE(le)
+    CHECK_COMPARE(lt)
+    CHECK_COMPARE(ge)
+    CHECK_COMPARE(gt)
+    CHECK_UNARY(sqrt)
+    CHECK_UNARY(exp)
+    CHECK_UNARY(sin)
+    CHECK_BINARY(hypot)
+    flint_soa_free(&x);
+    flint_soa_free(&y);
+    flint_soa_free(&z);
+#ifdef FLINT_DIRECTED_ROUNDING
+    printf("flint_soa with directed rounding: %d failures\n", failures);
+#else
+    printf("flint_soa: %d failures\n", failures);
+#endif
+    return failures != 0;
+}